@@ -7,6 +7,7 @@ import android.util.Base64
 import androidx.test.core.app.ApplicationProvider
 import androidx.test.ext.junit.runners.AndroidJUnit4
 import kotlinx.coroutines.test.runTest
+import mihon.data.panel.PanelDetectionRepositoryImpl
 import mihon.domain.ocr.interactor.OcrProcessor
 import mihon.domain.ocr.model.OcrImage
 import mihon.domain.ocr.model.OcrModel
@@ -37,6 +38,7 @@ class OcrRepositoryImplTest {
         context = ApplicationProvider.getApplicationContext()
         ocrRepository = OcrRepositoryImpl(
             context = context,
+            panelDetection = PanelDetectionRepositoryImpl(context),
             downloadPreferences = DownloadPreferences(AndroidPreferenceStore(context)),
         )
         ocrProcessor = OcrProcessor(ocrRepository)
@@ -118,12 +120,6 @@ class OcrRepositoryImplTest {
     }
 
     private fun Bitmap.toOcrImage(): OcrImage {
-        val pixels = IntArray(width * height)
-        getPixels(pixels, 0, width, 0, 0, width, height)
-        return OcrImage(
-            width = width,
-            height = height,
-            pixels = pixels,
-        )
+        return BitmapOcrImage(this, recycleOnRelease = false)
     }
 }
@@ -53,6 +53,7 @@ import mihon.domain.chapter.interactor.FilterChaptersForDownload
 import mihon.domain.dictionary.audio.DictionaryAudioPlayer
 import mihon.domain.dictionary.audio.DictionaryAudioRepository
 import mihon.domain.dictionary.interactor.DictionaryInteractor
+import mihon.domain.dictionary.interactor.DictionarySearchCache
 import mihon.domain.dictionary.interactor.SearchDictionaryTerms
 import mihon.domain.dictionary.repository.DictionaryLegacyRepository
 import mihon.domain.dictionary.repository.DictionaryMigrationStatusRepository
@@ -71,13 +72,16 @@ import mihon.domain.extensionrepo.interactor.UpdateExtensionRepo
 import mihon.domain.extensionrepo.repository.ExtensionRepoRepository
 import mihon.domain.extensionrepo.service.ExtensionRepoService
 import mihon.domain.migration.usecases.MigrateMangaUseCase
+import mihon.domain.ocr.interactor.CacheOcrPages
 import mihon.domain.ocr.interactor.ClearCachedChapterOcr
 import mihon.domain.ocr.interactor.ClearOcrCache
 import mihon.domain.ocr.interactor.GetCachedChapterIdsOcr
 import mihon.domain.ocr.interactor.GetCachedPageOcr
 import mihon.domain.ocr.interactor.GetOcrCacheSize
 import mihon.domain.ocr.interactor.OcrProcessor
+import mihon.domain.ocr.interactor.PrefetchChapterOcr
 import mihon.domain.ocr.interactor.ScanPageOcr
+import mihon.domain.ocr.interactor.TrackChapterOcrScan
 import mihon.domain.ocr.interactor.WithOcrScanSession
 import mihon.domain.ocr.repository.OcrRepository
 import mihon.domain.panel.interactor.DetectPanels
@@ -262,20 +266,21 @@ class DomainModule : InjektModule {
         addFactory { ToggleIncognito(get()) }
         addFactory { GetIncognitoState(get(), get(), get()) }
 
-        addSingletonFactory { DictionaryRepositoryImpl(get()) }
+        addSingletonFactory { DictionaryRepositoryImpl(get(), get()) }
         addSingletonFactory<DictionaryRepository> { get<DictionaryRepositoryImpl>() }
         addSingletonFactory<DictionaryLegacyRepository> { get<DictionaryRepositoryImpl>() }
         addSingletonFactory<DictionaryMigrationStatusRepository> { get<DictionaryRepositoryImpl>() }
         addSingletonFactory<DictionaryParser> { DictionaryParserImpl() }
-        addSingletonFactory { HoshiDictionaryStore(get<Application>(), get(), get()) }
+        addSingletonFactory { DictionarySearchCache() }
+        addSingletonFactory { HoshiDictionaryStore(get<Application>(), get(), get(), get()) }
         addSingletonFactory<DictionarySearchBackend> { get<HoshiDictionaryStore>() }
         addSingletonFactory<DictionaryStorageGateway> { get<HoshiDictionaryStore>() }
         addSingletonFactory { DictionarySearchGatewayImpl(get(), get()) }
         addSingletonFactory<DictionarySearchGateway> { get<DictionarySearchGatewayImpl>() }
         addSingletonFactory { LegacyDictionaryArchiveBuilder(get(), get()) }
         addSingletonFactory<DictionaryArchiveBuilder> { get<LegacyDictionaryArchiveBuilder>() }
-        addFactory { DictionaryInteractor(get()) }
-        addFactory { SearchDictionaryTerms(get(), get()) }
+        addFactory { DictionaryInteractor(get(), get()) }
+        addFactory { SearchDictionaryTerms(get(), get(), get()) }
         addSingletonFactory<DictionaryAudioRepository> { DictionaryAudioRepositoryImpl(get<Application>(), get()) }
         addSingletonFactory<DictionaryAudioPlayer> { DictionaryAudioPlayerImpl() }
 
@@ -287,6 +292,7 @@ class DomainModule : InjektModule {
         addSingletonFactory<OcrRepository> {
             OcrRepositoryImpl(
                 context = get<Application>(),
+                panelDetection = get(),
             )
         }
         addSingletonFactory { OcrScanStore(get<Application>(), get()) }
@@ -294,23 +300,27 @@ class DomainModule : InjektModule {
         addSingletonFactory { OcrPageSourceResolver(get(), get(), get()) }
         addSingletonFactory { ReaderSelectionCropper(get()) }
         addSingletonFactory { OcrScanNotifier(get<Application>()) }
-        addSingletonFactory { OcrChapterScanner(get<Application>(), get(), get(), get(), get(), get(), get(), get()) }
+        addSingletonFactory { OcrChapterScanner(get<Application>(), get(), get(), get(), get(), get(), get(), get(), get(), get()) }
         addSingletonFactory { OcrScanManager(get<Application>(), get(), get(), get()) }
         addFactory { OcrQueueActions(get(), get()) }
         addFactory { OcrProcessor(get()) }
         addFactory { WithOcrScanSession(get()) }
         addFactory { ScanPageOcr(get()) }
+        addFactory { CacheOcrPages(get()) }
         addFactory { GetCachedChapterIdsOcr(get()) }
         addFactory { GetCachedPageOcr(get()) }
+        addFactory { PrefetchChapterOcr(get()) }
         addFactory { ClearCachedChapterOcr(get()) }
+        addFactory { TrackChapterOcrScan(get()) }
         addFactory { ClearOcrCache(get()) }
         addFactory { GetOcrCacheSize(get()) }
 
-        addSingletonFactory<PanelDetectionRepository> {
+        addSingletonFactory {
             PanelDetectionRepositoryImpl(
                 context = get<Application>(),
             )
         }
+        addSingletonFactory<PanelDetectionRepository> { get<PanelDetectionRepositoryImpl>() }
         addFactory { DetectPanels(get()) }
     }
 }
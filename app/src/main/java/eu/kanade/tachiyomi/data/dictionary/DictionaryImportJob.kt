@@ -2,7 +2,9 @@ package eu.kanade.tachiyomi.data.dictionary
 
 import android.content.Context
 import android.net.Uri
+import android.os.Build
 import android.os.ParcelFileDescriptor
+import android.util.JsonReader
 import androidx.core.net.toUri
 import androidx.lifecycle.asFlow
 import androidx.work.CoroutineWorker
@@ -17,6 +19,9 @@ import eu.kanade.tachiyomi.network.TrustedFileDownloader
 import eu.kanade.tachiyomi.util.system.workManager
 import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.NonCancellable
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.ensureActive
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.map
 import kotlinx.coroutines.withContext
@@ -24,11 +29,20 @@ import logcat.LogPriority
 import mihon.core.archive.ArchiveReader
 import mihon.domain.dictionary.exception.DictionaryImportException
 import mihon.domain.dictionary.interactor.DictionaryInteractor
+import mihon.domain.dictionary.model.Dictionary
+import mihon.domain.dictionary.model.DictionaryBackend
 import mihon.domain.dictionary.model.DictionaryIndex
+import mihon.domain.dictionary.model.DictionaryMigrationStage
+import mihon.domain.dictionary.model.DictionaryMigrationState
+import mihon.domain.dictionary.model.DictionaryMigrationStatus
+import mihon.domain.dictionary.repository.DictionaryMigrationStatusRepository
+import mihon.domain.dictionary.repository.DictionaryRepository
 import mihon.domain.dictionary.service.DictionaryParseException
 import mihon.domain.dictionary.service.DictionaryParser
 import mihon.domain.dictionary.service.DictionaryStorageGateway
+import tachiyomi.core.common.i18n.stringResource
 import tachiyomi.core.common.util.system.logcat
+import tachiyomi.i18n.MR
 import uy.kohesive.injekt.Injekt
 import uy.kohesive.injekt.api.get
 import java.io.File
@@ -36,6 +50,10 @@ import java.io.File
 /**
  * Worker for importing dictionary files in the background.
  * Supports importing from local file URIs or remote URLs.
+ *
+ * The import runs in stages (fetch archive, import, validate, refresh session) and records the
+ * current stage in the migration status table. Each stage leaves a checkpoint, so a run that
+ * WorkManager restarts after process death resumes from the last completed stage.
  */
 class DictionaryImportJob(
     private val context: Context,
@@ -43,6 +61,8 @@ class DictionaryImportJob(
 ) : CoroutineWorker(context, workerParams) {
 
     private val dictionaryInteractor: DictionaryInteractor = Injekt.get()
+    private val dictionaryRepository: DictionaryRepository = Injekt.get()
+    private val migrationStatusRepository: DictionaryMigrationStatusRepository = Injekt.get()
     private val dictionaryParser: DictionaryParser = Injekt.get()
     private val networkHelper: NetworkHelper = Injekt.get()
     private val dictionaryStorageGateway: DictionaryStorageGateway = Injekt.get()
@@ -56,7 +76,8 @@ class DictionaryImportJob(
         }
 
         var tempFile: File? = null
-        var importedDictionaryId: Long? = null
+        var importingDictionaryId: Long? = null
+        var keepProgress = false
 
         return try {
             val archiveFile = withContext(Dispatchers.IO) {
@@ -66,30 +87,52 @@ class DictionaryImportJob(
                 }.also { tempFile = it }
             }
 
-            val outcome = ParcelFileDescriptor.open(archiveFile, ParcelFileDescriptor.MODE_READ_ONLY).use { pfd ->
+            ParcelFileDescriptor.open(archiveFile, ParcelFileDescriptor.MODE_READ_ONLY).use { pfd ->
                 ArchiveReader(pfd).use { reader ->
-                    extractAndImportDictionary(reader, archiveFile)
+                    extractAndImportDictionary(reader, archiveFile) { importingDictionaryId = it }
                 }
             }
 
-            importedDictionaryId = outcome.dictionaryId
             Result.success()
         } catch (e: CancellationException) {
+            if (isStoppedBySystem()) {
+                // WorkManager reruns this work under the same id, which picks up the pending
+                // dictionary and the cached archive again.
+                logcat(LogPriority.INFO) { "Dictionary import stopped by the system, keeping progress" }
+                keepProgress = true
+                throw e
+            }
             logcat(LogPriority.INFO) { "Dictionary import cancelled" }
-            cleanupPartialImport(importedDictionaryId)
+            withContext(NonCancellable) { cleanupPartialImport(importingDictionaryId) }
             throw e
         } catch (e: Exception) {
             logImportFailure(e)
-            cleanupPartialImport(importedDictionaryId)
+            cleanupPartialImport(importingDictionaryId)
             Result.failure()
         } finally {
-            runCatching { tempFile?.delete() }
+            if (!keepProgress) {
+                runCatching { tempFile?.delete() }
+                runCatching { pendingImportFile().delete() }
+            }
         }
     }
 
+    /**
+     * Whether the work was stopped by WorkManager (constraints, quota, process shutdown) rather than
+     * cancelled by the app. Stop reasons are only reported from API 31, so older releases treat
+     * every stop as a cancellation.
+     */
+    private fun isStoppedBySystem(): Boolean {
+        return isStopped &&
+            Build.VERSION.SDK_INT >= Build.VERSION_CODES.S &&
+            stopReason != WorkInfo.STOP_REASON_CANCELLED_BY_APP
+    }
+
     private suspend fun downloadRemoteArchive(url: String): File = withContext(Dispatchers.IO) {
         val downloadsDir = File(context.cacheDir, "dictionary_downloads").apply { mkdirs() }
-        val destination = File(downloadsDir, "dictionary_${System.currentTimeMillis()}.zip")
+        val destination = File(downloadsDir, "dictionary_$id.zip")
+        // The downloader only renames its partial file on success, so an existing file is complete.
+        if (destination.exists()) return@withContext destination
 
         val downloader = TrustedFileDownloader(
             client = networkHelper.nonCloudflareClient,
@@ -111,12 +154,19 @@ class DictionaryImportJob(
         }
 
         val cacheDir = File(context.cacheDir, "dictionary_imports").apply { mkdirs() }
-        val destination = File(cacheDir, "dictionary_${System.currentTimeMillis()}.zip")
+        val destination = File(cacheDir, "dictionary_$id.zip")
+        if (destination.exists()) return@withContext destination
+
+        val partial = File(cacheDir, "${destination.name}.partial")
         context.contentResolver.openInputStream(uri)?.use { input ->
-            destination.outputStream().buffered().use { output ->
+            partial.outputStream().buffered().use { output ->
                 input.copyTo(output)
             }
         } ?: throw DictionaryImportException.InvalidArchive("Failed to read dictionary file")
+        if (!partial.renameTo(destination)) {
+            partial.delete()
+            throw DictionaryImportException.InvalidArchive("Failed to read dictionary file")
+        }
 
         destination
     }
@@ -124,7 +174,8 @@ class DictionaryImportJob(
     private suspend fun extractAndImportDictionary(
         reader: ArchiveReader,
         archiveFile: File,
-    ): ImportOutcome {
+        onDictionaryCreated: (Long) -> Unit,
+    ) {
         val indexJson = reader.getInputStream("index.json")?.bufferedReader()?.use { it.readText() }
             ?: throw DictionaryImportException.InvalidArchive("index.json not found in dictionary archive")
 
@@ -134,37 +185,127 @@ class DictionaryImportJob(
             throw DictionaryParseException("Failed to parse index.json", e)
         }
 
-        if (dictionaryInteractor.isDictionaryAlreadyImported(index.title, index.revision)) {
-            throw DictionaryImportException.AlreadyImported
+        val dictionary = findInterruptedImport(index) ?: run {
+            if (dictionaryInteractor.isDictionaryAlreadyImported(index.title, index.revision)) {
+                throw DictionaryImportException.AlreadyImported
+            }
+
+            val styles = reader.getInputStream("styles.css")?.bufferedReader()?.use { it.readText() }
+            dictionaryInteractor.createDictionary(
+                index = index,
+                styles = styles,
+            ).also { created ->
+                withContext(Dispatchers.IO) { pendingImportFile().writeText(created.id.toString()) }
+            }
         }
+        onDictionaryCreated(dictionary.id)
 
-        val styles = reader.getInputStream("styles.css")?.bufferedReader()?.use { it.readText() }
+        // A previous run of this work may already have finished the native import.
+        var storagePath = dictionary.storagePath?.takeIf { path ->
+            path.isNotBlank() && dictionaryStorageGateway.validateImportedDictionary(path, sampleExpression = null)
+        }
+        if (storagePath == null) {
+            updateImportStage(
+                dictionaryId = dictionary.id,
+                stage = DictionaryMigrationStage.IMPORTING,
+                progressText = context.stringResource(MR.strings.dictionary_import_parsing_files),
+            )
+            val importOutcome = dictionaryStorageGateway.importDictionary(
+                archivePath = archiveFile.absolutePath,
+                dictionaryId = dictionary.id,
+                dictionaryTitle = dictionary.title,
+            )
+            if (!importOutcome.success || importOutcome.storagePath.isNullOrBlank()) {
+                throw DictionaryImportException.ImportFailed("Failed to import dictionary into hoshidicts")
+            }
+            // The native import cannot be interrupted, so honour cancellation as soon as it returns.
+            currentCoroutineContext().ensureActive()
+
+            storagePath = importOutcome.storagePath!!
+            dictionaryRepository.updateDictionaryStorage(
+                dictionaryId = dictionary.id,
+                backend = DictionaryBackend.HOSHI,
+                storagePath = storagePath,
+                storageReady = false,
+            )
+        }
 
-        val dictionary = dictionaryInteractor.createDictionary(
-            index = index,
-            styles = styles,
+        updateImportStage(
+            dictionaryId = dictionary.id,
+            stage = DictionaryMigrationStage.VALIDATING,
+            progressText = context.stringResource(MR.strings.dictionary_migration_stage_validating),
+        )
+        val isValid = dictionaryStorageGateway.validateImportedDictionary(
+            storagePath = storagePath,
+            sampleExpression = readSampleExpression(reader),
         )
+        if (!isValid) {
+            throw DictionaryImportException.ImportFailed("Validation failed for ${dictionary.title}")
+        }
+        currentCoroutineContext().ensureActive()
 
-        val importOutcome = dictionaryStorageGateway.importDictionary(
-            archivePath = archiveFile.absolutePath,
+        updateImportStage(
+            dictionaryId = dictionary.id,
+            stage = DictionaryMigrationStage.REBUILDING_SESSION,
+            progressText = context.stringResource(MR.strings.dictionary_migration_stage_rebuilding_session),
+        )
+        dictionaryRepository.updateDictionaryStorage(
             dictionaryId = dictionary.id,
-            dictionaryTitle = dictionary.title,
+            backend = DictionaryBackend.HOSHI,
+            storagePath = storagePath,
+            storageReady = true,
         )
-        if (!importOutcome.success || importOutcome.storagePath.isNullOrBlank()) {
-            throw DictionaryImportException.ImportFailed("Failed to import dictionary into hoshidicts")
+        dictionaryStorageGateway.refreshSearchSession()
+        migrationStatusRepository.deleteMigrationStatus(dictionary.id)
+    }
+
+    /**
+     * Returns the dictionary left behind by an interrupted run of this work, which is resumed
+     * instead of being rejected as a duplicate. Pending dictionaries of other imports are ignored.
+     */
+    private suspend fun findInterruptedImport(index: DictionaryIndex): Dictionary? {
+        val dictionaryId = withContext(Dispatchers.IO) {
+            pendingImportFile().takeIf { it.exists() }?.readText()?.trim()?.toLongOrNull()
+        } ?: return null
+        return dictionaryInteractor.getAllDictionaries().firstOrNull {
+            it.id == dictionaryId &&
+                it.title == index.title &&
+                it.revision == index.revision &&
+                DictionaryMigrationRecovery.isPendingImport(it)
         }
+    }
 
-        dictionaryInteractor.updateDictionary(
-            dictionary.copy(
-                storagePath = importOutcome.storagePath,
-                storageReady = true,
-            ),
-        )
+    /** Records the dictionary created by this work, keyed by work id like the cached archive. */
+    private fun pendingImportFile(): File {
+        val dir = File(context.filesDir, "dictionary_imports").apply { mkdirs() }
+        return File(dir, "dictionary_$id.pending")
+    }
 
-        dictionaryStorageGateway.refreshSearchSession()
+    /** Reads the first expression of the first term bank so validation can run a real lookup. */
+    private fun readSampleExpression(reader: ArchiveReader): String? {
+        val stream = reader.getInputStream("term_bank_1.json") ?: return null
+        return runCatching {
+            JsonReader(stream.bufferedReader()).use { json ->
+                json.beginArray()
+                if (!json.hasNext()) return@use null
+                json.beginArray()
+                json.nextString().takeIf { it.isNotBlank() }
+            }
+        }.getOrNull()
+    }
 
-        return ImportOutcome(
-            dictionaryId = dictionary.id,
+    private suspend fun updateImportStage(
+        dictionaryId: Long,
+        stage: DictionaryMigrationStage,
+        progressText: String,
+    ) {
+        migrationStatusRepository.upsertMigrationStatus(
+            DictionaryMigrationStatus(
+                dictionaryId = dictionaryId,
+                state = DictionaryMigrationState.RUNNING,
+                stage = stage,
+                progressText = progressText,
+            ),
         )
     }
 
@@ -266,8 +407,4 @@ class DictionaryImportJob(
                 }
         }
     }
-
-    private data class ImportOutcome(
-        val dictionaryId: Long,
-    )
 }
@@ -138,6 +138,7 @@ class DictionaryMigrationJob(
         val pending = dictionaries.filter { dictionary ->
             val status = statusesByDictionaryId[dictionary.id]
             when {
+                DictionaryMigrationRecovery.isPendingImport(dictionary) -> false
                 dictionary.backend == DictionaryBackend.LEGACY_DB ->
                     status?.state != DictionaryMigrationState.ERROR
                 status == null -> false
@@ -28,6 +28,14 @@ internal object DictionaryMigrationRecovery {
         }
     }
 
+    /**
+     * Imports create Hoshi-backed dictionaries that only become ready at the end, so such a
+     * dictionary belongs to a [DictionaryImportJob] that WorkManager will resume, not to a migration.
+     */
+    fun isPendingImport(dictionary: Dictionary): Boolean {
+        return dictionary.backend == DictionaryBackend.HOSHI && !dictionary.storageReady
+    }
+
     fun hasPendingMigration(
         legacyDictionaries: List<Dictionary>,
         statuses: List<DictionaryMigrationStatus>,
@@ -36,8 +44,10 @@ internal object DictionaryMigrationRecovery {
         val hasPendingLegacy = legacyDictionaries.any { dictionary ->
             statusesByDictionaryId[dictionary.id]?.state != DictionaryMigrationState.ERROR
         }
+        // Import jobs record their stages with no batch total; they resume on their own.
         val hasPendingStatuses = statuses.any { status ->
-            status.state != DictionaryMigrationState.COMPLETE &&
+            status.totalDictionaries > 0 &&
+                status.state != DictionaryMigrationState.COMPLETE &&
                 status.state != DictionaryMigrationState.ERROR
         }
         return hasPendingLegacy || hasPendingStatuses
@@ -1,28 +1,46 @@
 package eu.kanade.tachiyomi.data.ocr
 
+import android.app.ActivityManager
 import android.content.Context
+import androidx.core.content.getSystemService
+import eu.kanade.domain.manga.model.readingMode
 import eu.kanade.tachiyomi.R
+import eu.kanade.tachiyomi.ui.reader.setting.ReaderPreferences
+import eu.kanade.tachiyomi.ui.reader.setting.ReadingMode
 import eu.kanade.tachiyomi.util.ocr.toOcrImage
 import eu.kanade.tachiyomi.util.system.activeNetworkState
 import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.joinAll
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Semaphore
 import logcat.LogPriority
-import mihon.domain.ocr.interactor.ClearCachedChapterOcr
+import mihon.domain.ocr.interactor.CacheOcrPages
 import mihon.domain.ocr.interactor.ScanPageOcr
+import mihon.domain.ocr.interactor.TrackChapterOcrScan
 import mihon.domain.ocr.interactor.WithOcrScanSession
+import mihon.domain.ocr.model.OcrImage
+import mihon.domain.ocr.model.OcrPageResult
+import tachiyomi.core.common.util.system.ReadingDirection
 import tachiyomi.core.common.util.system.logcat
 import tachiyomi.domain.chapter.interactor.GetChapter
 import tachiyomi.domain.download.service.DownloadPreferences
 import tachiyomi.domain.manga.interactor.GetManga
+import tachiyomi.domain.manga.model.Manga
 
 internal class OcrChapterScanner(
     private val context: Context,
     private val getChapter: GetChapter,
     private val getManga: GetManga,
-    private val clearCachedChapterOcr: ClearCachedChapterOcr,
     private val withOcrScanSession: WithOcrScanSession,
     private val scanPageOcr: ScanPageOcr,
+    private val cacheOcrPages: CacheOcrPages,
+    private val trackChapterOcrScan: TrackChapterOcrScan,
     private val pageSourceResolver: OcrPageSourceResolver,
     private val downloadPreferences: DownloadPreferences,
+    private val readerPreferences: ReaderPreferences,
+    private val ocrParallelism: Int = DEFAULT_OCR_PARALLELISM,
 ) {
     suspend fun scanChapter(
         chapterId: Long,
@@ -61,11 +79,12 @@ internal class OcrChapterScanner(
 
         return try {
             withOcrScanSession.await {
-                clearCachedChapterOcr.await(chapterId)
-                onCacheStateChanged(chapterId, false)
-
+                // Existing results are kept until each page is rescanned: pages are replaced one by one,
+                // and unchanged images are served from the content-addressed cache without inference.
+                // A failed scan leaves them in place too, since every persisted page is a valid result, but
+                // the chapter only counts as cached again once a scan has covered all of its pages.
                 val resolvedPages = pageSourceResolver.resolve(manga, chapter)
-                resolvedPages.use pageScope@{ pages ->
+                resolvedPages.use { pages ->
                     if (pages.pages.isEmpty()) {
                         onError(
                             OcrChapterScanError(
@@ -91,44 +110,31 @@ internal class OcrChapterScanner(
                         onProgress(lastProgress)
 
                         try {
-                            var chapterHasCachedResults = false
-                            for ((index, page) in pages.pages.withIndex()) {
-                                val networkError = checkNetworkState()
-                                if (networkError != null) {
-                                    clearCachedChapterOcr.await(chapterId)
-                                    onCacheStateChanged(chapterId, false)
-                                    onError(
-                                        OcrChapterScanError(
-                                            mangaId = manga.id,
-                                            mangaTitle = manga.title,
-                                            chapterId = chapterId,
-                                            chapterName = chapter.name,
-                                            failure = OcrScanFailure.Unexpected(networkError),
-                                        ),
-                                    )
-                                    return@pageScope false
-                                }
-
-                                val bitmap = page.openBitmap() ?: error("Unable to decode page ${page.pageIndex + 1}")
-                                try {
-                                    scanPageOcr.await(chapterId, page.pageIndex, bitmap.toOcrImage())
-                                } finally {
-                                    if (!bitmap.isRecycled) {
-                                        bitmap.recycle()
-                                    }
-                                }
-
-                                if (!chapterHasCachedResults) {
-                                    chapterHasCachedResults = true
-                                    onCacheStateChanged(chapterId, true)
-                                }
+                            val scanStartedAt = trackChapterOcrScan.start(chapterId)
+                            onCacheStateChanged(chapterId, false)
 
-                                lastProgress = lastProgress.copy(processedPages = index + 1)
+                            var processedPages = 0
+                            scanPages(chapterId, pages.pages, manga.readingDirection()) { persistedPages ->
+                                processedPages += persistedPages
+                                lastProgress = lastProgress.copy(processedPages = processedPages)
                                 onProgress(lastProgress)
                             }
 
+                            trackChapterOcrScan.finish(chapterId, scanStartedAt)
+                            onCacheStateChanged(chapterId, true)
                             onComplete(lastProgress)
                             true
+                        } catch (e: NetworkUnavailableException) {
+                            onError(
+                                OcrChapterScanError(
+                                    mangaId = manga.id,
+                                    mangaTitle = manga.title,
+                                    chapterId = chapterId,
+                                    chapterName = chapter.name,
+                                    failure = OcrScanFailure.Unexpected(e.message),
+                                ),
+                            )
+                            false
                         } catch (e: Throwable) {
                             handleUnexpectedFailure(
                                 chapterId = chapterId,
@@ -138,7 +144,6 @@ internal class OcrChapterScanner(
                                 throwable = e,
                                 logMessage = "Failed to scan OCR",
                                 onError = onError,
-                                onCacheStateChanged = onCacheStateChanged,
                             )
                         }
                     }
@@ -153,11 +158,91 @@ internal class OcrChapterScanner(
                 throwable = e,
                 logMessage = "Failed to start OCR scan",
                 onError = onError,
-                onCacheStateChanged = onCacheStateChanged,
             )
         }
     }
 
+    /**
+     * Scans [pages] as a three-stage pipeline: pages are decoded ahead on one coroutine, OCR runs on
+     * [ocrParallelism] workers, and results are written to the cache in batches. The number of
+     * decoded pages alive at once, whether waiting or being scanned, is capped from the memory class,
+     * so decoding never runs far ahead of inference.
+     */
+    private suspend fun scanPages(
+        chapterId: Long,
+        pages: List<OcrPageInput>,
+        direction: ReadingDirection,
+        onPersisted: (pageCount: Int) -> Unit,
+    ) {
+        val decodedBudget = Semaphore(decodedPageBudget())
+        val decodedPages = Channel<DecodedPage>(Channel.UNLIMITED) {
+            it.image.close()
+            decodedBudget.release()
+        }
+        val scannedPages = Channel<OcrPageResult>(PERSIST_BATCH_SIZE)
+
+        try {
+            coroutineScope {
+                launch {
+                    try {
+                        for (page in pages) {
+                            checkNetworkState()?.let { throw NetworkUnavailableException(it) }
+                            decodedBudget.acquire()
+                            val bitmap = try {
+                                page.openBitmap() ?: error("Unable to decode page ${page.pageIndex + 1}")
+                            } catch (e: Throwable) {
+                                decodedBudget.release()
+                                throw e
+                            }
+                            decodedPages.send(DecodedPage(page.pageIndex, bitmap.toOcrImage()))
+                        }
+                    } finally {
+                        decodedPages.close()
+                    }
+                }
+
+                val scanners = List(ocrParallelism) {
+                    launch {
+                        for (decoded in decodedPages) {
+                            val result = try {
+                                decoded.image.use { image ->
+                                    scanPageOcr.await(chapterId, decoded.pageIndex, image, direction, persist = false)
+                                }
+                            } finally {
+                                decodedBudget.release()
+                            }
+                            scannedPages.send(result)
+                        }
+                    }
+                }
+                launch {
+                    scanners.joinAll()
+                    scannedPages.close()
+                }
+
+                // Whatever finished while the previous batch was being written goes in the next one.
+                for (first in scannedPages) {
+                    val batch = mutableListOf(first)
+                    while (batch.size < PERSIST_BATCH_SIZE) {
+                        batch += scannedPages.tryReceive().getOrNull() ?: break
+                    }
+                    cacheOcrPages.await(batch)
+                    onPersisted(batch.size)
+                }
+            }
+        } finally {
+            // Releases pages that were decoded but never scanned.
+            decodedPages.cancel()
+        }
+    }
+
+    /** Decoded pages the memory class allows at once, counting both queued and in-progress pages. */
+    private fun decodedPageBudget(): Int {
+        val memoryClassMb = context.getSystemService<ActivityManager>()?.memoryClass ?: return 1
+        return (memoryClassMb / DECODE_AHEAD_MEMORY_DIVISOR / DECODED_PAGE_ESTIMATE_MB)
+            .coerceIn(1, ocrParallelism + MAX_DECODE_AHEAD)
+    }
+
     private suspend fun handleUnexpectedFailure(
         chapterId: Long,
         chapterName: String,
@@ -166,15 +251,12 @@ internal class OcrChapterScanner(
         throwable: Throwable,
         logMessage: String,
         onError: (OcrChapterScanError) -> Unit,
-        onCacheStateChanged: (chapterId: Long, hasResults: Boolean) -> Unit,
     ): Boolean {
         if (throwable is CancellationException) {
             throw throwable
         }
 
         logcat(LogPriority.ERROR, throwable) { "$logMessage for chapterId=$chapterId" }
-        clearCachedChapterOcr.await(chapterId)
-        onCacheStateChanged(chapterId, false)
         onError(
             OcrChapterScanError(
                 mangaId = mangaId,
@@ -187,6 +269,18 @@ internal class OcrChapterScanner(
         return false
     }
 
+    /** Reading direction of the manga's reading mode, so text regions come back in reading order. */
+    private fun Manga.readingDirection(): ReadingDirection {
+        val mode = ReadingMode.fromPreference(readingMode.toInt())
+            .takeIf { it != ReadingMode.DEFAULT }
+            ?: ReadingMode.fromPreference(readerPreferences.defaultReadingMode().get())
+        return when (mode) {
+            ReadingMode.LEFT_TO_RIGHT -> ReadingDirection.LTR
+            ReadingMode.VERTICAL, ReadingMode.WEBTOON, ReadingMode.CONTINUOUS_VERTICAL -> ReadingDirection.VERTICAL
+            else -> ReadingDirection.RTL
+        }
+    }
+
     private fun checkNetworkState(): String? {
         val state = context.activeNetworkState()
         return if (state.isOnline) {
@@ -200,8 +294,27 @@ internal class OcrChapterScanner(
             context.getString(R.string.download_notifier_no_network)
         }
     }
+
+    companion object {
+        // Matches the network engines' concurrency, so Glens and OwOCR uploads stay saturated.
+        const val DEFAULT_OCR_PARALLELISM = 3
+
+        private const val PERSIST_BATCH_SIZE = 8
+        private const val MAX_DECODE_AHEAD = 4
+
+        // Rough size of a decoded ARGB manga page, and the share of the heap decoded pages may use.
+        private const val DECODED_PAGE_ESTIMATE_MB = 12
+        private const val DECODE_AHEAD_MEMORY_DIVISOR = 8
+    }
 }
 
+private class DecodedPage(
+    val pageIndex: Int,
+    val image: OcrImage,
+)
+
+private class NetworkUnavailableException(message: String) : Exception(message)
+
 internal data class OcrChapterScanProgress(
     val mangaId: Long,
     val mangaTitle: String,
@@ -4,7 +4,9 @@ import android.app.Application
 import android.os.Build
 import androidx.core.content.ContextCompat
 import androidx.sqlite.db.SupportSQLiteDatabase
+import androidx.sqlite.db.SupportSQLiteOpenHelper
 import androidx.sqlite.db.framework.FrameworkSQLiteOpenHelperFactory
+import app.cash.sqldelight.db.QueryResult
 import app.cash.sqldelight.db.SqlDriver
 import app.cash.sqldelight.driver.android.AndroidSqliteDriver
 import eu.kanade.domain.track.store.DelayedTrackingStore
@@ -23,6 +25,7 @@ import eu.kanade.tachiyomi.source.AndroidSourceManager
 import io.requery.android.database.sqlite.RequerySQLiteOpenHelperFactory
 import kotlinx.serialization.json.Json
 import kotlinx.serialization.protobuf.ProtoBuf
+import mihon.data.dictionary.DictionaryReadDatabase
 import nl.adaptivity.xmlutil.XmlDeclMode
 import nl.adaptivity.xmlutil.core.XmlVersion
 import nl.adaptivity.xmlutil.serialization.XML
@@ -55,12 +58,7 @@ class AppModule(val app: Application) : InjektModule {
                 schema = Database.Schema,
                 context = app,
                 name = "tachiyomi.db",
-                factory = if (BuildConfig.DEBUG && Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
-                    // Support database inspector in Android Studio
-                    FrameworkSQLiteOpenHelperFactory()
-                } else {
-                    RequerySQLiteOpenHelperFactory()
-                },
+                factory = openHelperFactory(),
                 callback = object : AndroidSqliteDriver.Callback(Database.Schema) {
                     override fun onOpen(db: SupportSQLiteDatabase) {
                         super.onOpen(db)
@@ -89,6 +87,32 @@ class AppModule(val app: Application) : InjektModule {
             )
         }
         addSingletonFactory<DatabaseHandler> { AndroidDatabaseHandler(get(), get()) }
+        addSingletonFactory {
+            DictionaryReadDatabase(
+                openDatabase = {
+                    // Open the primary connection first so it alone creates and migrates the schema
+                    get<SqlDriver>().executeQuery(null, "PRAGMA user_version", { QueryResult.Unit }, 0)
+                    Database(
+                        driver = AndroidSqliteDriver(
+                            // Same SQLite build as the primary driver so both share file locks
+                            openHelper = openHelperFactory().create(
+                                SupportSQLiteOpenHelper.Configuration.builder(app)
+                                    .name("tachiyomi.db")
+                                    .callback(DictionaryReadCallback)
+                                    .build(),
+                            ),
+                        ),
+                        historyAdapter = History.Adapter(
+                            last_readAdapter = DateColumnAdapter,
+                        ),
+                        mangasAdapter = Mangas.Adapter(
+                            genreAdapter = StringListColumnAdapter,
+                            update_strategyAdapter = UpdateStrategyColumnAdapter,
+                        ),
+                    )
+                },
+            )
+        }
 
         addSingletonFactory {
             Json {
@@ -146,3 +170,30 @@ class AppModule(val app: Application) : InjektModule {
         }
     }
 }
+
+private fun openHelperFactory(): SupportSQLiteOpenHelper.Factory {
+    return if (BuildConfig.DEBUG && Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+        // Support database inspector in Android Studio
+        FrameworkSQLiteOpenHelperFactory()
+    } else {
+        RequerySQLiteOpenHelperFactory()
+    }
+}
+
+/**
+ * Connections to the main database used only for dictionary lookups. WAL mode gives the helper a
+ * pool of reader connections; schema changes and all writes stay with the primary driver.
+ */
+private object DictionaryReadCallback : SupportSQLiteOpenHelper.Callback(Database.Schema.version.toInt()) {
+    override fun onConfigure(db: SupportSQLiteDatabase) {
+        db.enableWriteAheadLogging()
+    }
+
+    override fun onCreate(db: SupportSQLiteDatabase) {
+        error("Dictionary read connections must not create the database")
+    }
+
+    override fun onUpgrade(db: SupportSQLiteDatabase, oldVersion: Int, newVersion: Int) {
+        error("Dictionary read connections must not migrate the database")
+    }
+}
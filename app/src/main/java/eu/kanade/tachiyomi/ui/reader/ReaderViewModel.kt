@@ -59,6 +59,7 @@ import kotlinx.coroutines.runBlocking
 import logcat.LogPriority
 import mihon.domain.ocr.exception.OcrException
 import mihon.domain.ocr.interactor.OcrProcessor
+import mihon.domain.ocr.interactor.PrefetchChapterOcr
 import mihon.domain.ocr.model.flattenOcrTextForQuery
 import mihon.domain.ocr.repository.OcrRepository
 import mihon.domain.panel.repository.PanelDetectionRepository
@@ -155,6 +156,7 @@ class ReaderViewModel @JvmOverloads constructor(
     private var chapterToDownload: Download? = null
 
     private val ocrProcessor: OcrProcessor by injectLazy()
+    private val prefetchChapterOcr: PrefetchChapterOcr by injectLazy()
 
     private val unfilteredChapterList by lazy {
         val manga = manga!!
@@ -329,6 +331,7 @@ class ReaderViewModel @JvmOverloads constructor(
         chapter: ReaderChapter,
     ): ViewerChapters {
         loader.loadChapter(chapter)
+        prefetchOcr(chapter)
 
         val chapterPos = chapterList.indexOf(chapter)
         val newChapters = ViewerChapters(
@@ -353,6 +356,24 @@ class ReaderViewModel @JvmOverloads constructor(
         return newChapters
     }
 
+    /**
+     * Warms the OCR cache of [chapter] in the background, so cached overlays appear on page turn
+     * without a database round-trip.
+     */
+    private fun prefetchOcr(chapter: ReaderChapter) {
+        val chapterId = chapter.chapter.id ?: return
+        viewModelScope.launchIO {
+            try {
+                prefetchChapterOcr.await(chapterId)
+            } catch (e: Throwable) {
+                if (e is CancellationException) {
+                    throw e
+                }
+                logcat(LogPriority.WARN, e) { "Failed to prefetch OCR cache for chapter $chapterId" }
+            }
+        }
+    }
+
     /**
      * Called when the user changed to the given [chapter] when changing pages from the viewer.
      * It's used only to set this chapter as active.
@@ -429,6 +450,7 @@ class ReaderViewModel @JvmOverloads constructor(
         }
 
         val loader = loader ?: return
+        prefetchOcr(chapter)
         try {
             logcat { "Preloading ${chapter.chapter.url}" }
             loader.loadChapter(chapter)
@@ -851,7 +873,7 @@ class ReaderViewModel @JvmOverloads constructor(
         viewModelScope.launchIO {
             mutableState.update { it.copy(isProcessingOcr = true, ocrSelectionMode = false) }
             try {
-                val text = ocrProcessor.getText(bitmap.toOcrImage())
+                val text = bitmap.toOcrImage().use { image -> ocrProcessor.getText(image) }
                 withUIContext {
                     val queryText = flattenOcrTextForQuery(text)
                     if (queryText.isNotBlank()) {
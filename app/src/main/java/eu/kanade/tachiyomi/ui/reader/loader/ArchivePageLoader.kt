@@ -12,17 +12,26 @@ import tachiyomi.core.common.util.system.ImageUtil
 internal class ArchivePageLoader(private val reader: ArchiveReader) : PageLoader() {
     override var isLocal: Boolean = true
 
-    override suspend fun getPages(): List<ReaderPage> = reader.useEntries { entries ->
-        entries
-            .filter { it.isFile && ImageUtil.isImage(it.name) { reader.getInputStream(it.name)!! } }
-            .sortedWith { f1, f2 -> f1.name.compareToCaseInsensitiveNaturalOrder(f2.name) }
-            .mapIndexed { i, entry ->
+    override suspend fun getPages(): List<ReaderPage> {
+        // Sniff every entry in place during one sequential pass instead of reopening the archive per entry.
+        val images = mutableListOf<Pair<String, ImageUtil.ImageInfo?>>()
+        reader.useEntriesAndStreams { entry, stream ->
+            if (!entry.isFile) return@useEntriesAndStreams
+            val info = ImageUtil.readImageInfo(stream)
+            if (info != null || ImageUtil.isImage(entry.name)) {
+                images += entry.name to info
+            }
+        }
+
+        return images
+            .sortedWith { (name1, _), (name2, _) -> name1.compareToCaseInsensitiveNaturalOrder(name2) }
+            .mapIndexed { i, (name, info) ->
                 ReaderPage(i).apply {
-                    stream = { reader.getInputStream(entry.name)!! }
+                    stream = { reader.getInputStream(name)!! }
+                    imageInfo = info
                     status = Page.State.Ready
                 }
             }
-            .toList()
     }
 
     override suspend fun loadPage(page: ReaderPage) {
@@ -7,5 +7,6 @@ class InsertPage(val parent: ReaderPage) : ReaderPage(parent.index, parent.url,
     init {
         status = State.Ready
         stream = parent.stream
+        imageInfo = parent.imageInfo
     }
 }
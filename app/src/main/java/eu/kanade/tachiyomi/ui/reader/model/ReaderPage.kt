@@ -1,6 +1,7 @@
 package eu.kanade.tachiyomi.ui.reader.model
 
 import eu.kanade.tachiyomi.source.model.Page
+import tachiyomi.core.common.util.system.ImageUtil
 import java.io.InputStream
 
 open class ReaderPage(
@@ -11,4 +12,9 @@ open class ReaderPage(
 ) : Page(index, url, imageUrl, null) {
 
     open lateinit var chapter: ReaderChapter
+
+    /**
+     * Header metadata sniffed by the loader while listing pages, so viewers can skip reading it again.
+     */
+    var imageInfo: ImageUtil.ImageInfo? = null
 }
@@ -2,13 +2,10 @@ package eu.kanade.tachiyomi.ui.reader.viewer.pager
 
 import android.annotation.SuppressLint
 import android.content.Context
-import android.graphics.Bitmap
 import android.graphics.drawable.Drawable
 import android.view.LayoutInflater
 import androidx.core.view.isVisible
 import eu.kanade.presentation.util.formattedMessage
-import eu.kanade.tachiyomi.data.ocr.decodeImageDecoderBitmap
-import eu.kanade.tachiyomi.data.ocr.decodeImageDecoderBounds
 import eu.kanade.tachiyomi.databinding.ReaderErrorBinding
 import eu.kanade.tachiyomi.source.model.Page
 import eu.kanade.tachiyomi.ui.reader.model.InsertPage
@@ -36,7 +33,6 @@ import tachiyomi.core.common.util.lang.withIOContext
 import tachiyomi.core.common.util.lang.withUIContext
 import tachiyomi.core.common.util.system.ImageUtil
 import tachiyomi.core.common.util.system.Panel
-import tachiyomi.core.common.util.system.ReadingDirection
 import tachiyomi.core.common.util.system.logcat
 import tachiyomi.i18n.MR
 import uy.kohesive.injekt.Injekt
@@ -264,7 +260,7 @@ class PagerPageHolder(
         }
 
         val generation = panelDetectionGeneration
-        val cacheKey = panelDetectionCacheKey()
+        val cacheKey = panelDetectionCacheKey(page)
         val decoded = loadResult.panelBitmap
         if (decoded == null) {
             logcat(LogPriority.VERBOSE) { "Panel nav detection skipped index=${page.index}: no processed panel bitmap" }
@@ -273,13 +269,15 @@ class PagerPageHolder(
 
         panelDetectionJob = scope.launchIO {
             val result = try {
-                detectPanels.await(
-                    cacheKey = cacheKey,
-                    image = decoded.bitmap,
-                    originalWidth = decoded.originalWidth,
-                    originalHeight = decoded.originalHeight,
-                    direction = readingDirection(),
-                )
+                viewer.panelLookahead.foreground {
+                    detectPanels.await(
+                        cacheKey = cacheKey,
+                        image = decoded.bitmap,
+                        originalWidth = decoded.originalWidth,
+                        originalHeight = decoded.originalHeight,
+                        direction = viewer.panelReadingDirection(),
+                    )
+                }
             } finally {
                 decoded.bitmap.recycle()
             }
@@ -308,55 +306,6 @@ class PagerPageHolder(
         }
     }
 
-    private fun decodePanelBitmap(source: BufferedSource): DecodedPanelBitmap? {
-        val bounds = source.peek().inputStream().use(::decodeImageDecoderBounds)
-        if (bounds == null) {
-            logcat(LogPriority.VERBOSE) { "Panel nav decodeBitmap failed: bounds unavailable" }
-            return null
-        }
-
-        val largestDimension = maxOf(bounds.width, bounds.height)
-        if (largestDimension <= 0) {
-            logcat(LogPriority.VERBOSE) { "Panel nav decodeBitmap failed: dimensions <= 0" }
-            return null
-        }
-
-        val sampleSize = generateSequence(1) { it * 2 }
-            .first { largestDimension / it <= 800 }
-
-        val bitmap = source.peek().inputStream().use {
-            decodeImageDecoderBitmap(it, sampleSize)
-        }
-
-        if (bitmap == null) {
-            logcat(LogPriority.VERBOSE) {
-                "Panel nav decodeBitmap failed: bitmap null after decode with sampleSize=$sampleSize"
-            }
-            return null
-        }
-
-        logcat(LogPriority.VERBOSE) {
-            "Panel nav decodeBitmap success sampleSize=$sampleSize " +
-                "bitmapSize=${bitmap.width}x${bitmap.height} " +
-                "originalSize=${bounds.width}x${bounds.height} " +
-                "config=${bitmap.config}"
-        }
-
-        return DecodedPanelBitmap(
-            bitmap = bitmap,
-            originalWidth = bounds.width,
-            originalHeight = bounds.height,
-        )
-    }
-
-    private fun readingDirection(): ReadingDirection {
-        return when (viewer) {
-            is R2LPagerViewer -> ReadingDirection.RTL
-            is VerticalPagerViewer -> ReadingDirection.VERTICAL
-            else -> ReadingDirection.LTR
-        }
-    }
-
     fun hasPanels(): Boolean = panels.isNotEmpty()
 
     fun hasNextPanel(): Boolean = hasPanels() && currentPanelIndex < panels.lastIndex
@@ -430,24 +379,9 @@ class PagerPageHolder(
         }
     }
 
-    private fun panelDetectionCacheKey(): String {
-        val pageType = if (page is InsertPage) "insert" else "page"
-        return buildString {
-            append(page.chapter.chapter.id)
-            append(':')
-            append(page.index)
-            append(':')
-            append(pageType)
-            append(':')
-            append(page.url)
-            append(':')
-            append(page.imageUrl ?: "")
-        }
-    }
-
     private fun process(page: ReaderPage, imageSource: BufferedSource): BufferedSource {
         if (viewer.config.dualPageRotateToFit) {
-            return rotateDualPage(imageSource)
+            return rotateDualPage(page, imageSource)
         }
 
         if (!viewer.config.dualPageSplit) {
@@ -458,7 +392,7 @@ class PagerPageHolder(
             return splitInHalf(imageSource)
         }
 
-        val isDoublePage = ImageUtil.isWideImage(imageSource)
+        val isDoublePage = page.imageInfo?.isWide ?: ImageUtil.isWideImage(imageSource)
         if (!isDoublePage) {
             return imageSource
         }
@@ -468,8 +402,8 @@ class PagerPageHolder(
         return splitInHalf(imageSource)
     }
 
-    private fun rotateDualPage(imageSource: BufferedSource): BufferedSource {
-        val isDoublePage = ImageUtil.isWideImage(imageSource)
+    private fun rotateDualPage(page: ReaderPage, imageSource: BufferedSource): BufferedSource {
+        val isDoublePage = page.imageInfo?.isWide ?: ImageUtil.isWideImage(imageSource)
         return if (isDoublePage) {
             val rotation = if (viewer.config.dualPageRotateToFitInvert) -90f else 90f
             ImageUtil.rotateImage(imageSource, rotation)
@@ -590,9 +524,3 @@ private data class LoadResult(
     val panelBitmap: DecodedPanelBitmap?,
     val cropRect: android.graphics.Rect?,
 )
-
-private data class DecodedPanelBitmap(
-    val bitmap: Bitmap,
-    val originalWidth: Int,
-    val originalHeight: Int,
-)
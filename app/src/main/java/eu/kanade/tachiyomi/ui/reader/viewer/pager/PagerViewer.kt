@@ -51,6 +51,11 @@ abstract class PagerViewer(val activity: ReaderActivity) : Viewer {
      */
     val config = PagerConfig(this, scope)
 
+    /**
+     * Detects panels on upcoming pages in the background while panel navigation is enabled.
+     */
+    val panelLookahead = PanelDetectionLookahead(this, scope)
+
     /**
      * Adapter of the pager.
      */
@@ -305,6 +310,7 @@ abstract class PagerViewer(val activity: ReaderActivity) : Viewer {
 
         // Notify holder of page change
         getPageHolder(page)?.onPageSelected(forward)
+        panelLookahead.onPageSelected(page)
 
         // Skip preload on inserts it causes unwanted page jumping
         if (page is InsertPage) {
@@ -327,6 +333,7 @@ abstract class PagerViewer(val activity: ReaderActivity) : Viewer {
      */
     private fun onTransitionSelected(transition: ChapterTransition) {
         logcat { "onTransitionSelected: $transition" }
+        panelLookahead.cancel()
         activity.dismissActiveOcrOverlaySession()
         val toChapter = transition.to
         if (toChapter != null) {
@@ -0,0 +1,203 @@
+package eu.kanade.tachiyomi.ui.reader.viewer.pager
+
+import android.graphics.Bitmap
+import eu.kanade.tachiyomi.data.ocr.decodeImageDecoderBitmap
+import eu.kanade.tachiyomi.data.ocr.decodeImageDecoderBounds
+import eu.kanade.tachiyomi.source.model.Page
+import eu.kanade.tachiyomi.ui.reader.model.InsertPage
+import eu.kanade.tachiyomi.ui.reader.model.ReaderChapter
+import eu.kanade.tachiyomi.ui.reader.model.ReaderPage
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.update
+import kotlinx.coroutines.launch
+import logcat.LogPriority
+import mihon.domain.panel.interactor.DetectPanels
+import okio.Buffer
+import okio.BufferedSource
+import tachiyomi.core.common.util.system.ImageUtil
+import tachiyomi.core.common.util.system.ReadingDirection
+import tachiyomi.core.common.util.system.logcat
+import uy.kohesive.injekt.Injekt
+import uy.kohesive.injekt.api.get
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Runs panel detection on the pages after the current one, so panel navigation is ready by the
+ * time they are shown. Results land in the [DetectPanels] caches, where the page holder finds them.
+ *
+ * Work is done one page at a time on a single background thread, waits while a visible page is
+ * detecting panels, and is restarted whenever the current page changes.
+ */
+class PanelDetectionLookahead(
+    private val viewer: PagerViewer,
+    private val scope: CoroutineScope,
+    private val lookaheadPages: Int = LOOKAHEAD_PAGES,
+) {
+    private val detectPanels: DetectPanels by lazy { Injekt.get() }
+
+    private val dispatcher = Dispatchers.IO.limitedParallelism(1)
+    private val foregroundDetections = MutableStateFlow(0)
+    private val detectedKeys = ConcurrentHashMap.newKeySet<String>()
+
+    private var job: Job? = null
+    private var chapter: ReaderChapter? = null
+
+    fun onPageSelected(page: ReaderPage) {
+        cancel()
+        // Look-ahead never leaves the current chapter, so keys of the previous one are dead weight.
+        if (page.chapter !== chapter) {
+            chapter = page.chapter
+            detectedKeys.clear()
+        }
+        val config = viewer.config
+        // Split or rotated pages are detected on a processed image the look-ahead doesn't reproduce.
+        if (!config.panelNavigation || config.dualPageSplit || config.dualPageRotateToFit) return
+
+        val upcoming = page.chapter.pages
+            ?.drop(page.index + 1)
+            ?.take(lookaheadPages)
+            .orEmpty()
+        if (upcoming.isEmpty()) return
+
+        job = scope.launch(dispatcher) {
+            upcoming.forEach { upcomingPage ->
+                try {
+                    detectAhead(upcomingPage)
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (e: Throwable) {
+                    logcat(LogPriority.WARN, e) { "Panel nav look-ahead failed index=${upcomingPage.index}" }
+                }
+            }
+        }
+    }
+
+    fun cancel() {
+        job?.cancel()
+        job = null
+    }
+
+    /** Runs detection for a visible page; look-ahead work holds back until it completes. */
+    suspend fun <T> foreground(block: suspend () -> T): T {
+        foregroundDetections.update { it + 1 }
+        try {
+            return block()
+        } finally {
+            foregroundDetections.update { it - 1 }
+        }
+    }
+
+    private suspend fun detectAhead(page: ReaderPage) {
+        val cacheKey = panelDetectionCacheKey(page)
+        if (cacheKey in detectedKeys) return
+
+        // Loaders preload upcoming pages on their own; this only waits for their streams.
+        val state = page.statusFlow.first { it == Page.State.Ready || it is Page.State.Error }
+        val streamFn = page.stream
+        if (state != Page.State.Ready || streamFn == null) return
+
+        awaitForegroundIdle()
+        val source = streamFn().use { Buffer().readFrom(it) }
+        if (page.imageInfo?.isAnimated == true || ImageUtil.isAnimatedAndSupported(source)) return
+        val decoded = decodePanelBitmap(source) ?: return
+
+        awaitForegroundIdle()
+        try {
+            detectPanels.await(
+                cacheKey = cacheKey,
+                image = decoded.bitmap,
+                originalWidth = decoded.originalWidth,
+                originalHeight = decoded.originalHeight,
+                direction = viewer.panelReadingDirection(),
+            )
+        } finally {
+            decoded.bitmap.recycle()
+        }
+        detectedKeys += cacheKey
+        logcat(LogPriority.VERBOSE) { "Panel nav look-ahead detected index=${page.index}" }
+    }
+
+    private suspend fun awaitForegroundIdle() {
+        foregroundDetections.first { it == 0 }
+    }
+
+    private companion object {
+        const val LOOKAHEAD_PAGES = 2
+    }
+}
+
+internal data class DecodedPanelBitmap(
+    val bitmap: Bitmap,
+    val originalWidth: Int,
+    val originalHeight: Int,
+)
+
+/** Decodes [source] downsampled to at most 800px on its longest side for panel detection. */
+internal fun decodePanelBitmap(source: BufferedSource): DecodedPanelBitmap? {
+    val bounds = source.peek().inputStream().use(::decodeImageDecoderBounds)
+    if (bounds == null) {
+        logcat(LogPriority.VERBOSE) { "Panel nav decodeBitmap failed: bounds unavailable" }
+        return null
+    }
+
+    val largestDimension = maxOf(bounds.width, bounds.height)
+    if (largestDimension <= 0) {
+        logcat(LogPriority.VERBOSE) { "Panel nav decodeBitmap failed: dimensions <= 0" }
+        return null
+    }
+
+    val sampleSize = generateSequence(1) { it * 2 }
+        .first { largestDimension / it <= 800 }
+
+    val bitmap = source.peek().inputStream().use {
+        decodeImageDecoderBitmap(it, sampleSize)
+    }
+
+    if (bitmap == null) {
+        logcat(LogPriority.VERBOSE) {
+            "Panel nav decodeBitmap failed: bitmap null after decode with sampleSize=$sampleSize"
+        }
+        return null
+    }
+
+    logcat(LogPriority.VERBOSE) {
+        "Panel nav decodeBitmap success sampleSize=$sampleSize " +
+            "bitmapSize=${bitmap.width}x${bitmap.height} " +
+            "originalSize=${bounds.width}x${bounds.height} " +
+            "config=${bitmap.config}"
+    }
+
+    return DecodedPanelBitmap(
+        bitmap = bitmap,
+        originalWidth = bounds.width,
+        originalHeight = bounds.height,
+    )
+}
+
+internal fun panelDetectionCacheKey(page: ReaderPage): String {
+    val pageType = if (page is InsertPage) "insert" else "page"
+    return buildString {
+        append(page.chapter.chapter.id)
+        append(':')
+        append(page.index)
+        append(':')
+        append(pageType)
+        append(':')
+        append(page.url)
+        append(':')
+        append(page.imageUrl ?: "")
+    }
+}
+
+internal fun PagerViewer.panelReadingDirection(): ReadingDirection {
+    return when (this) {
+        is R2LPagerViewer -> ReadingDirection.RTL
+        is VerticalPagerViewer -> ReadingDirection.VERTICAL
+        else -> ReadingDirection.LTR
+    }
+}
@@ -221,11 +221,12 @@ class WebtoonPageHolder(
     private suspend fun setImage() {
         progressIndicator.setProgress(0)
 
+        val imageInfo = page?.imageInfo
         val streamFn = page?.stream ?: return
 
         try {
             val (source, isAnimated, cropRect) = withIOContext {
-                val source = streamFn().use { process(Buffer().readFrom(it)) }
+                val source = streamFn().use { process(Buffer().readFrom(it), imageInfo) }
                 val isAnimated = ImageUtil.isAnimatedAndSupported(source)
                 val cropRect = if (!isAnimated && viewer.config.imageCropBorders) {
                     ImageUtil.detectBorderCrop(source)
@@ -256,13 +257,13 @@ class WebtoonPageHolder(
         }
     }
 
-    private fun process(imageSource: BufferedSource): BufferedSource {
+    private fun process(imageSource: BufferedSource, imageInfo: ImageUtil.ImageInfo?): BufferedSource {
         if (viewer.config.dualPageRotateToFit) {
-            return rotateDualPage(imageSource)
+            return rotateDualPage(imageSource, imageInfo)
         }
 
         if (viewer.config.dualPageSplit) {
-            val isDoublePage = ImageUtil.isWideImage(imageSource)
+            val isDoublePage = imageInfo?.isWide ?: ImageUtil.isWideImage(imageSource)
             if (isDoublePage) {
                 val upperSide = if (viewer.config.dualPageInvert) ImageUtil.Side.LEFT else ImageUtil.Side.RIGHT
                 return ImageUtil.splitAndMerge(imageSource, upperSide)
@@ -272,8 +273,8 @@ class WebtoonPageHolder(
         return imageSource
     }
 
-    private fun rotateDualPage(imageSource: BufferedSource): BufferedSource {
-        val isDoublePage = ImageUtil.isWideImage(imageSource)
+    private fun rotateDualPage(imageSource: BufferedSource, imageInfo: ImageUtil.ImageInfo?): BufferedSource {
+        val isDoublePage = imageInfo?.isWide ?: ImageUtil.isWideImage(imageSource)
         return if (isDoublePage) {
             val rotation = if (viewer.config.dualPageRotateToFitInvert) -90f else 90f
             ImageUtil.rotateImage(imageSource, rotation)
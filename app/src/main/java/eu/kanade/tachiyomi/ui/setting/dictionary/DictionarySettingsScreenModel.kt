@@ -76,11 +76,13 @@ internal class DictionarySettingsScreenModel(
         screenModelScope.launch {
             dictionaryMigrationStatusRepository.subscribeToMigrationStatuses().collectLatest { statuses ->
                 val activeStatuses = statuses.filter { it.state != DictionaryMigrationState.COMPLETE }
-                val currentStatus = activeStatuses.firstOrNull()
+                // Imports report their stages per dictionary without belonging to a migration batch.
+                val batchStatuses = activeStatuses.filter { it.totalDictionaries > 0 }
+                val currentStatus = batchStatuses.firstOrNull()
                 mutableState.update {
                     it.copy(
                         migrationStatuses = activeStatuses,
-                        isMigrating = activeStatuses.isNotEmpty(),
+                        isMigrating = batchStatuses.isNotEmpty(),
                         currentMigrationStatus = currentStatus,
                     )
                 }
@@ -1,14 +1,13 @@
 package eu.kanade.tachiyomi.util.ocr
 
 import android.graphics.Bitmap
+import mihon.data.ocr.BitmapOcrImage
 import mihon.domain.ocr.model.OcrImage
 
-internal fun Bitmap.toOcrImage(): OcrImage {
-    val pixels = IntArray(width * height)
-    getPixels(pixels, 0, width, 0, 0, width, height)
-    return OcrImage(
-        width = width,
-        height = height,
-        pixels = pixels,
-    )
+/**
+ * Wraps this bitmap for OCR without copying its pixels. The returned image takes ownership and
+ * recycles the bitmap when released, unless [recycleOnRelease] is `false`.
+ */
+internal fun Bitmap.toOcrImage(recycleOnRelease: Boolean = true): OcrImage {
+    return BitmapOcrImage(this, recycleOnRelease)
 }
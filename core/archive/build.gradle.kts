@@ -12,4 +12,7 @@ dependencies {
     implementation(libs.jsoup)
     implementation(libs.libarchive)
     implementation(libs.unifile)
+
+    testImplementation(libs.bundles.test)
+    testRuntimeOnly(libs.junit.platform.launcher)
 }
@@ -5,17 +5,33 @@ import android.system.Os
 import android.system.OsConstants
 import me.zhanghai.android.libarchive.ArchiveException
 import java.io.Closeable
+import java.io.IOException
 import java.io.InputStream
+import java.nio.ByteBuffer
+import java.nio.channels.FileChannel
 
 class ArchiveReader(pfd: ParcelFileDescriptor) : Closeable {
     private val size = pfd.statSize
     private val address = Os.mmap(0, size, OsConstants.PROT_READ, OsConstants.MAP_PRIVATE, pfd.fileDescriptor, 0)
 
+    // The native mapping is only reachable through libarchive, so indexed reads use a JVM mapping of the same file.
+    private val mappedBuffer = mapForIndex(pfd, size)
+    private val zipIndex by lazy { mappedBuffer?.let(ZipIndex::parse) }
+
     fun <T> useEntries(block: (Sequence<ArchiveEntry>) -> T): T = ArchiveInputStream(address, size).use {
         block(generateSequence { it.getNextEntry() })
     }
 
+    /**
+     * Returns a stream over [entryName], or null if the archive has no such entry.
+     * ZIP archives are served from an index of their central directory; other formats are scanned.
+     */
     fun getInputStream(entryName: String): InputStream? {
+        zipIndex?.let { index ->
+            index.getInputStream(entryName)?.let { return it }
+            if (index.isComplete && entryName !in index) return null
+        }
+
         val archive = ArchiveInputStream(address, size)
         try {
             while (true) {
@@ -44,4 +60,16 @@ class ArchiveReader(pfd: ParcelFileDescriptor) : Closeable {
     override fun close() {
         Os.munmap(address, size)
     }
+
+    private fun mapForIndex(pfd: ParcelFileDescriptor, size: Long): ByteBuffer? {
+        if (size !in 1..Int.MAX_VALUE) return null
+        return try {
+            // The mapping outlives the duplicated descriptor, leaving the caller's descriptor untouched.
+            ParcelFileDescriptor.AutoCloseInputStream(pfd.dup()).use {
+                it.channel.map(FileChannel.MapMode.READ_ONLY, 0, size)
+            }
+        } catch (e: IOException) {
+            null
+        }
+    }
 }
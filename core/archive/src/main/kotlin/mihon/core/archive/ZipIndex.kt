@@ -0,0 +1,242 @@
+package mihon.core.archive
+
+import java.io.InputStream
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.zip.Inflater
+import java.util.zip.InflaterInputStream
+
+/**
+ * Name to location index of a ZIP archive, built once from its central directory.
+ *
+ * Stored entries are served as slices of [buffer] and deflated entries are inflated straight from
+ * it, so opening an entry costs the same wherever it sits in the archive. Entries the index can't
+ * serve (encrypted, other compression methods, non UTF-8 names) are left out and [isComplete] is
+ * false, in which case callers must fall back to a sequential scan for names that aren't found.
+ */
+internal class ZipIndex private constructor(
+    private val buffer: ByteBuffer,
+    private val entries: Map<String, Entry>,
+    val isComplete: Boolean,
+) {
+    private class Entry(
+        val localHeaderOffset: Int,
+        val method: Int,
+        val compressedSize: Int,
+        val uncompressedSize: Int,
+    )
+
+    operator fun contains(entryName: String) = entryName in entries
+
+    /** Returns a stream over [entryName], or null if the index has no such entry. */
+    fun getInputStream(entryName: String): InputStream? {
+        val entry = entries[entryName] ?: return null
+        val view = buffer.duplicate().order(ByteOrder.LITTLE_ENDIAN)
+
+        val header = entry.localHeaderOffset
+        if (header + LOCAL_HEADER_SIZE > view.limit() || view.getInt(header) != LOCAL_HEADER_SIGNATURE) {
+            return null
+        }
+        val dataStart = header + LOCAL_HEADER_SIZE +
+            view.getShort(header + 26).toUShort().toInt() +
+            view.getShort(header + 28).toUShort().toInt()
+        val dataEnd = dataStart.toLong() + entry.compressedSize
+        if (dataEnd > view.limit()) return null
+
+        return when (entry.method) {
+            METHOD_STORED -> ByteBufferInputStream(view.slice(dataStart, dataEnd.toInt()))
+            // Raw inflate wants one byte past the compressed data to report completion, and a
+            // valid archive always has at least the central directory after every entry.
+            METHOD_DEFLATED -> EntryInflaterStream(
+                ByteBufferInputStream(view.slice(dataStart, minOf(dataEnd + 1, view.limit().toLong()).toInt())),
+                entry.uncompressedSize,
+            )
+            else -> null
+        }
+    }
+
+    private fun ByteBuffer.slice(start: Int, end: Int): ByteBuffer {
+        return duplicate().apply {
+            position(start)
+            limit(end)
+        }.slice()
+    }
+
+    private class ByteBufferInputStream(private val buffer: ByteBuffer) : InputStream() {
+        override fun read(): Int {
+            return if (buffer.hasRemaining()) buffer.get().toUByte().toInt() else -1
+        }
+
+        override fun read(b: ByteArray, off: Int, len: Int): Int {
+            if (len == 0) return 0
+            if (!buffer.hasRemaining()) return -1
+            val count = minOf(len, buffer.remaining())
+            buffer.get(b, off, count)
+            return count
+        }
+
+        override fun skip(n: Long): Long {
+            val count = n.coerceIn(0, buffer.remaining().toLong()).toInt()
+            buffer.position(buffer.position() + count)
+            return count.toLong()
+        }
+
+        override fun available() = buffer.remaining()
+    }
+
+    private class EntryInflaterStream(source: InputStream, uncompressedSize: Int) :
+        InflaterInputStream(source, Inflater(true), inflateBufferSize(uncompressedSize)) {
+        private var closed = false
+
+        override fun close() {
+            if (closed) return
+            closed = true
+            inf.end()
+            super.close()
+        }
+    }
+
+    companion object {
+        private const val EOCD_SIGNATURE = 0x06054b50
+        private const val EOCD_SIZE = 22
+        private const val ZIP64_EOCD_LOCATOR_SIGNATURE = 0x07064b50
+        private const val ZIP64_EOCD_LOCATOR_SIZE = 20
+        private const val ZIP64_EOCD_SIGNATURE = 0x06064b50
+        private const val CENTRAL_HEADER_SIGNATURE = 0x02014b50
+        private const val CENTRAL_HEADER_SIZE = 46
+        private const val LOCAL_HEADER_SIGNATURE = 0x04034b50
+        private const val LOCAL_HEADER_SIZE = 30
+        private const val ZIP64_EXTRA_ID = 0x0001
+        private const val MAX_COMMENT_LENGTH = 0xFFFF
+
+        private const val FLAG_ENCRYPTED = 0x0001
+        private const val FLAG_UTF8 = 0x0800
+
+        private const val METHOD_STORED = 0
+        private const val METHOD_DEFLATED = 8
+
+        private const val UINT16_MAX = 0xFFFFL
+        private const val UINT32_MAX = 0xFFFFFFFFL
+
+        private fun inflateBufferSize(uncompressedSize: Int) = uncompressedSize.coerceIn(512, 64 * 1024)
+
+        /** Indexes the ZIP archive in [buffer], or returns null if it isn't one this index can read. */
+        fun parse(buffer: ByteBuffer): ZipIndex? {
+            val view = buffer.duplicate().order(ByteOrder.LITTLE_ENDIAN)
+            val eocd = findEndOfCentralDirectory(view) ?: return null
+
+            var entryCount = view.getShort(eocd + 10).toUShort().toLong()
+            var directorySize = view.getInt(eocd + 12).toUInt().toLong()
+            var directoryOffset = view.getInt(eocd + 16).toUInt().toLong()
+
+            if (entryCount == UINT16_MAX || directorySize == UINT32_MAX || directoryOffset == UINT32_MAX) {
+                val locator = eocd - ZIP64_EOCD_LOCATOR_SIZE
+                if (locator < 0 || view.getInt(locator) != ZIP64_EOCD_LOCATOR_SIGNATURE) return null
+                val zip64Eocd = view.getLong(locator + 8)
+                if (zip64Eocd !in 0..(view.limit() - 56L)) return null
+                if (view.getInt(zip64Eocd.toInt()) != ZIP64_EOCD_SIGNATURE) return null
+                entryCount = view.getLong(zip64Eocd.toInt() + 32)
+                directorySize = view.getLong(zip64Eocd.toInt() + 40)
+                directoryOffset = view.getLong(zip64Eocd.toInt() + 48)
+            }
+            if (directoryOffset < 0 || directorySize < 0 || directoryOffset + directorySize > view.limit()) {
+                return null
+            }
+
+            val entries = HashMap<String, Entry>()
+            var isComplete = true
+            var position = directoryOffset.toInt()
+            val directoryEnd = (directoryOffset + directorySize).toInt()
+            repeat(entryCount.coerceAtMost(Int.MAX_VALUE.toLong()).toInt()) {
+                if (position + CENTRAL_HEADER_SIZE > directoryEnd) return null
+                if (view.getInt(position) != CENTRAL_HEADER_SIGNATURE) return null
+
+                val flags = view.getShort(position + 8).toInt()
+                val method = view.getShort(position + 10).toUShort().toInt()
+                var compressedSize = view.getInt(position + 20).toUInt().toLong()
+                var uncompressedSize = view.getInt(position + 24).toUInt().toLong()
+                val nameLength = view.getShort(position + 28).toUShort().toInt()
+                val extraLength = view.getShort(position + 30).toUShort().toInt()
+                val commentLength = view.getShort(position + 32).toUShort().toInt()
+                var localHeaderOffset = view.getInt(position + 42).toUInt().toLong()
+
+                val nameStart = position + CENTRAL_HEADER_SIZE
+                val extraStart = nameStart + nameLength
+                val next = extraStart + extraLength + commentLength
+                if (next > directoryEnd) return null
+
+                // Sizes and offsets that overflow 32 bits move to the ZIP64 extra field, in this order.
+                var extra = extraStart
+                while (extra + 4 <= extraStart + extraLength) {
+                    val id = view.getShort(extra).toUShort().toInt()
+                    val length = view.getShort(extra + 2).toUShort().toInt()
+                    if (id == ZIP64_EXTRA_ID) {
+                        var field = extra + 4
+                        val fieldEnd = field + length
+                        if (uncompressedSize == UINT32_MAX && field + 8 <= fieldEnd) {
+                            uncompressedSize = view.getLong(field)
+                            field += 8
+                        }
+                        if (compressedSize == UINT32_MAX && field + 8 <= fieldEnd) {
+                            compressedSize = view.getLong(field)
+                            field += 8
+                        }
+                        if (localHeaderOffset == UINT32_MAX && field + 8 <= fieldEnd) {
+                            localHeaderOffset = view.getLong(field)
+                        }
+                        break
+                    }
+                    extra += 4 + length
+                }
+
+                val indexable = flags and FLAG_ENCRYPTED == 0 &&
+                    (flags and FLAG_UTF8 != 0 || view.isAscii(nameStart, nameLength)) &&
+                    (method == METHOD_DEFLATED || (method == METHOD_STORED && compressedSize == uncompressedSize)) &&
+                    localHeaderOffset in 0..<directoryOffset &&
+                    compressedSize in 0..Int.MAX_VALUE &&
+                    uncompressedSize in 0..Int.MAX_VALUE
+
+                if (indexable) {
+                    val name = view.decodeUtf8(nameStart, nameLength)
+                    // A sequential scan returns the first of duplicate names, so keep that one too.
+                    entries.putIfAbsent(
+                        name,
+                        Entry(localHeaderOffset.toInt(), method, compressedSize.toInt(), uncompressedSize.toInt()),
+                    )
+                } else {
+                    isComplete = false
+                }
+                position = next
+            }
+
+            return ZipIndex(buffer, entries, isComplete)
+        }
+
+        private fun findEndOfCentralDirectory(view: ByteBuffer): Int? {
+            val last = view.limit() - EOCD_SIZE
+            if (last < 0) return null
+            val first = (last - MAX_COMMENT_LENGTH).coerceAtLeast(0)
+            for (position in last downTo first) {
+                if (view.getInt(position) == EOCD_SIGNATURE &&
+                    position + EOCD_SIZE + view.getShort(position + 20).toUShort().toInt() == view.limit()
+                ) {
+                    return position
+                }
+            }
+            return null
+        }
+
+        private fun ByteBuffer.isAscii(start: Int, length: Int): Boolean {
+            for (index in start..<start + length) {
+                if (get(index) < 0) return false
+            }
+            return true
+        }
+
+        private fun ByteBuffer.decodeUtf8(start: Int, length: Int): String {
+            val bytes = ByteArray(length)
+            duplicate().apply { position(start) }.get(bytes)
+            return bytes.decodeToString()
+        }
+    }
+}
@@ -0,0 +1,89 @@
+package mihon.core.archive
+
+import org.junit.jupiter.api.Assertions.assertArrayEquals
+import org.junit.jupiter.api.Assertions.assertEquals
+import org.junit.jupiter.api.Assertions.assertFalse
+import org.junit.jupiter.api.Assertions.assertNotNull
+import org.junit.jupiter.api.Assertions.assertNull
+import org.junit.jupiter.api.Assertions.assertTrue
+import org.junit.jupiter.api.Test
+import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.util.zip.CRC32
+import java.util.zip.ZipEntry
+import java.util.zip.ZipOutputStream
+import kotlin.random.Random
+
+class ZipIndexTest {
+
+    private fun zip(vararg entries: Pair<String, ByteArray>, stored: Boolean = false, comment: String? = null): ByteArray {
+        val output = ByteArrayOutputStream()
+        ZipOutputStream(output).use { zip ->
+            comment?.let(zip::setComment)
+            entries.forEach { (name, data) ->
+                val entry = ZipEntry(name)
+                if (stored) {
+                    entry.method = ZipEntry.STORED
+                    entry.size = data.size.toLong()
+                    entry.crc = CRC32().apply { update(data) }.value
+                }
+                zip.putNextEntry(entry)
+                zip.write(data)
+                zip.closeEntry()
+            }
+        }
+        return output.toByteArray()
+    }
+
+    private fun page(index: Int) = Random(index).nextBytes(4096) + ByteArray(4096) { index.toByte() }
+
+    @Test
+    fun `stored entries are read back byte for byte`() {
+        val pages = (0..<50).map { "page_$it.jpg" to page(it) }
+        val index = ZipIndex.parse(ByteBuffer.wrap(zip(*pages.toTypedArray(), stored = true)))
+
+        assertNotNull(index)
+        assertTrue(index!!.isComplete)
+        pages.forEach { (name, data) ->
+            assertArrayEquals(data, index.getInputStream(name)!!.use { it.readBytes() })
+        }
+    }
+
+    @Test
+    fun `deflated entries are inflated`() {
+        val pages = (0..<20).map { "chapter/page_$it.png" to page(it) }
+        val index = ZipIndex.parse(ByteBuffer.wrap(zip(*pages.toTypedArray(), comment = "comic")))!!
+
+        pages.reversed().forEach { (name, data) ->
+            assertArrayEquals(data, index.getInputStream(name)!!.use { it.readBytes() })
+        }
+    }
+
+    @Test
+    fun `streams over the same entry are independent`() {
+        val data = page(7)
+        val index = ZipIndex.parse(ByteBuffer.wrap(zip("a.jpg" to data, stored = true)))!!
+
+        val first = index.getInputStream("a.jpg")!!
+        val second = index.getInputStream("a.jpg")!!
+        first.skip(100)
+
+        assertEquals(data[0].toUByte().toInt(), second.read())
+        assertEquals(data[100].toUByte().toInt(), first.read())
+    }
+
+    @Test
+    fun `UTF-8 names are found and unknown names are absent`() {
+        val index = ZipIndex.parse(ByteBuffer.wrap(zip("ページ.jpg" to page(1), "cover.jpg" to page(2))))!!
+
+        assertNotNull(index.getInputStream("ページ.jpg"))
+        assertNull(index.getInputStream("missing.jpg"))
+        assertFalse("missing.jpg" in index)
+    }
+
+    @Test
+    fun `non zip data is not indexed`() {
+        assertNull(ZipIndex.parse(ByteBuffer.wrap(ByteArray(0))))
+        assertNull(ZipIndex.parse(ByteBuffer.wrap(Random(0).nextBytes(1024))))
+    }
+}
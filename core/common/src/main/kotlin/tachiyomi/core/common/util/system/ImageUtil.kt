@@ -50,21 +50,47 @@ object ImageUtil {
 
     fun findImageType(stream: InputStream): ImageType? {
         return try {
-            when (getImageType(stream)?.format) {
-                Format.Avif -> ImageType.AVIF
-                Format.Gif -> ImageType.GIF
-                Format.Heif -> ImageType.HEIF
-                Format.Jpeg -> ImageType.JPEG
-                Format.Jxl -> ImageType.JXL
-                Format.Png -> ImageType.PNG
-                Format.Webp -> ImageType.WEBP
-                else -> null
-            }
+            getImageType(stream)?.format?.toImageType()
         } catch (e: Exception) {
             null
         }
     }
 
+    /**
+     * Reads the type, dimensions and animation flag from the header of [stream] without decoding
+     * pixels, or returns null if it isn't a supported image. The header bytes are consumed.
+     */
+    fun readImageInfo(stream: InputStream): ImageInfo? {
+        return try {
+            val buffered = stream.buffered()
+            val decoderType = getImageType(buffered) ?: return null
+            val type = decoderType.format.toImageType() ?: return null
+            val options = BitmapFactory.Options().apply { inJustDecodeBounds = true }
+            BitmapFactory.decodeStream(buffered, null, options)
+            ImageInfo(
+                type = type,
+                width = options.outWidth.coerceAtLeast(0),
+                height = options.outHeight.coerceAtLeast(0),
+                isAnimated = decoderType.isAnimated,
+            )
+        } catch (e: Exception) {
+            null
+        }
+    }
+
+    private fun Format.toImageType(): ImageType? {
+        return when (this) {
+            Format.Avif -> ImageType.AVIF
+            Format.Gif -> ImageType.GIF
+            Format.Heif -> ImageType.HEIF
+            Format.Jpeg -> ImageType.JPEG
+            Format.Jxl -> ImageType.JXL
+            Format.Png -> ImageType.PNG
+            Format.Webp -> ImageType.WEBP
+            else -> null
+        }
+    }
+
     fun getExtensionFromMimeType(mime: String?, openStream: () -> InputStream): String {
         val type = mime?.let { ImageType.entries.find { it.mime == mime } } ?: findImageType(openStream)
         return type?.extension ?: "jpg"
@@ -114,6 +140,20 @@ object ImageUtil {
         WEBP("image/webp", "webp"),
     }
 
+    /**
+     * Header metadata of an image. [width] and [height] are 0 when the platform can't read them.
+     */
+    data class ImageInfo(
+        val type: ImageType,
+        val width: Int,
+        val height: Int,
+        val isAnimated: Boolean,
+    ) {
+        /** Same as [isWideImage], or null if the dimensions are unknown. */
+        val isWide: Boolean?
+            get() = if (width > 0 && height > 0) width > height else null
+    }
+
     /**
      * Check whether the image is wide (which we consider a double-page spread).
      *
@@ -206,75 +246,24 @@ object ImageUtil {
 
     private fun findBorderTop(bitmap: Bitmap): Int {
         val width = bitmap.width
-        val height = bitmap.height
         val filledLimit = (width * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
-
-        var whitePixels = 0
-        var blackPixels = 0
-        for (x in 0 until width step 2) {
-            if (bitmap.isBlack(x, 0)) {
-                blackPixels++
-            } else if (bitmap.isWhite(x, 0)) {
-                whitePixels++
-            }
-        }
-
-        val detectWhite = blackPixels > filledLimit
-        if (whitePixels > filledLimit && blackPixels > filledLimit) {
-            return 0
-        }
-
-        for (y in 1 until height) {
-            var filledCount = 0
-            for (x in 0 until width step 2) {
-                val filled = if (detectWhite) bitmap.isWhite(x, y) else bitmap.isBlack(x, y)
-                if (filled) {
-                    filledCount++
-                }
-            }
-            if (filledCount > filledLimit) {
-                return y
-            }
-        }
-
-        return 0
+        val row = IntArray(width)
+        return scanBorder(row, filledLimit, edge = 0, inward = 1..<bitmap.height) { y ->
+            bitmap.getPixels(row, 0, width, 0, y, width, 1)
+            width
+        } ?: 0
     }
 
     private fun findBorderBottom(bitmap: Bitmap): Int {
         val width = bitmap.width
         val height = bitmap.height
         val filledLimit = (width * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
-
-        val lastY = height - 1
-        var whitePixels = 0
-        var blackPixels = 0
-        for (x in 0 until width step 2) {
-            if (bitmap.isBlack(x, lastY)) {
-                blackPixels++
-            } else if (bitmap.isWhite(x, lastY)) {
-                whitePixels++
-            }
+        val row = IntArray(width)
+        val y = scanBorder(row, filledLimit, edge = height - 1, inward = (height - 2) downTo 1) { y ->
+            bitmap.getPixels(row, 0, width, 0, y, width, 1)
+            width
         }
-
-        val detectWhite = blackPixels > filledLimit
-        if (whitePixels > filledLimit && blackPixels > filledLimit) {
-            return height
-        }
-
-        for (y in (height - 2) downTo 1) {
-            var filledCount = 0
-            for (x in 0 until width step 2) {
-                val filled = if (detectWhite) bitmap.isWhite(x, y) else bitmap.isBlack(x, y)
-                if (filled) {
-                    filledCount++
-                }
-            }
-            if (filledCount > filledLimit) {
-                return y + 1
-            }
-        }
-
-        return height
+        return if (y != null) y + 1 else height
     }
 
     private fun findBorderLeft(
@@ -282,39 +271,11 @@ object ImageUtil {
         top: Int,
         bottom: Int,
     ): Int {
-        val width = bitmap.width
-        val height = bitmap.height
-        val filledLimit = (height * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
-
-        var whitePixels = 0
-        var blackPixels = 0
-        for (y in top until bottom step 2) {
-            if (bitmap.isBlack(0, y)) {
-                blackPixels++
-            } else if (bitmap.isWhite(0, y)) {
-                whitePixels++
-            }
-        }
-
-        val detectWhite = blackPixels > filledLimit
-        if (whitePixels > filledLimit && blackPixels > filledLimit) {
-            return 0
-        }
-
-        for (x in 1 until width) {
-            var filledCount = 0
-            for (y in top until bottom step 2) {
-                val filled = if (detectWhite) bitmap.isWhite(x, y) else bitmap.isBlack(x, y)
-                if (filled) {
-                    filledCount++
-                }
-            }
-            if (filledCount > filledLimit) {
-                return x
-            }
-        }
-
-        return 0
+        val filledLimit = (bitmap.height * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
+        val column = IntArray(max(bottom - top, 0))
+        return scanBorder(column, filledLimit, edge = 0, inward = 1..<bitmap.width) { x ->
+            bitmap.readColumn(column, x, top, bottom)
+        } ?: 0
     }
 
     private fun findBorderRight(
@@ -323,53 +284,82 @@ object ImageUtil {
         bottom: Int,
     ): Int {
         val width = bitmap.width
-        val height = bitmap.height
-        val filledLimit = (height * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
+        val filledLimit = (bitmap.height * BORDER_FILLED_RATIO_LIMIT / 2f).roundToInt()
+        val column = IntArray(max(bottom - top, 0))
+        val x = scanBorder(column, filledLimit, edge = width - 1, inward = (width - 2) downTo 1) { x ->
+            bitmap.readColumn(column, x, top, bottom)
+        }
+        return if (x != null) x + 1 else width
+    }
 
-        val lastX = width - 1
+    /**
+     * Classifies the [edge] line as a black or white border and returns the first [inward] line
+     * whose every other pixel is filled with the opposite colour more than [filledLimit] times, or
+     * null if the edge is mixed or no line qualifies. [load] fills [pixels] with a line and returns
+     * its length, so each line costs one bulk pixel read.
+     */
+    private inline fun scanBorder(
+        pixels: IntArray,
+        filledLimit: Int,
+        edge: Int,
+        inward: IntProgression,
+        load: (line: Int) -> Int,
+    ): Int? {
+        val edgeLength = load(edge)
         var whitePixels = 0
         var blackPixels = 0
-        for (y in top until bottom step 2) {
-            if (bitmap.isBlack(lastX, y)) {
+        for (i in 0..<edgeLength step 2) {
+            val pixel = pixels[i]
+            if (pixel.isBorderBlack()) {
                 blackPixels++
-            } else if (bitmap.isWhite(lastX, y)) {
+            } else if (pixel.isBorderWhite()) {
                 whitePixels++
             }
         }
 
         val detectWhite = blackPixels > filledLimit
         if (whitePixels > filledLimit && blackPixels > filledLimit) {
-            return width
+            return null
         }
 
-        for (x in (width - 2) downTo 1) {
-            var filledCount = 0
-            for (y in top until bottom step 2) {
-                val filled = if (detectWhite) bitmap.isWhite(x, y) else bitmap.isBlack(x, y)
-                if (filled) {
-                    filledCount++
-                }
-            }
-            if (filledCount > filledLimit) {
-                return x + 1
+        for (line in inward) {
+            val length = load(line)
+            if (isFilled(pixels, length, detectWhite, filledLimit)) {
+                return line
             }
         }
-
-        return width
+        return null
     }
 
-    private fun Bitmap.isBlack(x: Int, y: Int): Boolean {
-        val pixel = this[x, y]
-        val luma = ((pixel.red * 299) + (pixel.green * 587) + (pixel.blue * 114)) / 1000
-        return luma < BORDER_THRESHOLD_FOR_BLACK
+    /** Whether more than [filledLimit] of the even-indexed pixels match, stopping as soon as it's decided. */
+    private fun isFilled(pixels: IntArray, length: Int, detectWhite: Boolean, filledLimit: Int): Boolean {
+        var remaining = (length + 1) / 2
+        var filledCount = 0
+        for (i in 0..<length step 2) {
+            val pixel = pixels[i]
+            val filled = if (detectWhite) pixel.isBorderWhite() else pixel.isBorderBlack()
+            if (filled && ++filledCount > filledLimit) return true
+            if (filledCount + --remaining <= filledLimit) return false
+        }
+        return false
     }
 
-    private fun Bitmap.isWhite(x: Int, y: Int): Boolean {
-        val pixel = this[x, y]
-        val luma = ((pixel.red * 299) + (pixel.green * 587) + (pixel.blue * 114)) / 1000
-        return luma > BORDER_THRESHOLD_FOR_WHITE
+    private fun Bitmap.readColumn(column: IntArray, x: Int, top: Int, bottom: Int): Int {
+        val length = bottom - top
+        if (length > 0) {
+            getPixels(column, 0, 1, x, top, 1, length)
+        }
+        return length
     }
 
+    private fun Int.scaledLuma(): Int =
+        LUMA_RED[(this shr 16) and 0xFF] + LUMA_GREEN[(this shr 8) and 0xFF] + LUMA_BLUE[this and 0xFF]
+
+    // Same as comparing luma / 1000 against the thresholds, without the division.
+    private fun Int.isBorderBlack(): Boolean = scaledLuma() < BORDER_THRESHOLD_FOR_BLACK * 1000
+
+    private fun Int.isBorderWhite(): Boolean = scaledLuma() >= (BORDER_THRESHOLD_FOR_WHITE + 1) * 1000
+
     /**
      * Split the image into left and right parts, then merge them into a new image.
      */
@@ -612,7 +602,11 @@ object ImageUtil {
         var topWhiteStreak = 0
         var botBlackStreak = 0
         var botWhiteStreak = 0
+        val column = IntArray(image.height)
+        val offsetColumn = IntArray(image.height)
         outer@ for (x in intArrayOf(left, right, leftOffsetX, rightOffsetX)) {
+            image.readColumn(column, x, 0, image.height)
+            image.readColumn(offsetColumn, x + (if (x < image.width / 2) -offsetX else offsetX), 0, image.height)
             var whitePixelsStreak = 0
             var whitePixels = 0
             var blackPixelsStreak = 0
@@ -621,8 +615,8 @@ object ImageUtil {
             var whiteStreak = false
             val notOffset = x == left || x == right
             inner@ for ((index, y) in (0..<image.height step image.height / 25).withIndex()) {
-                val pixel = image[x, y]
-                val pixelOff = image[x + (if (x < image.width / 2) -offsetX else offsetX), y]
+                val pixel = column[y]
+                val pixelOff = offsetColumn[y]
                 if (pixel.isWhite()) {
                     whitePixelsStreak++
                     whitePixels++
@@ -902,5 +896,10 @@ private const val BORDER_FILLED_RATIO_LIMIT = 0.0025f
 private const val BORDER_THRESHOLD_FOR_BLACK = (255f * 0.75f).toInt()
 private const val BORDER_THRESHOLD_FOR_WHITE = (255f - (255f * 0.75f)).toInt()
 
+// Rec. 601 luma scaled by 1000, split per channel so a pixel costs three lookups and no divide.
+private val LUMA_RED = IntArray(256) { it * 299 }
+private val LUMA_GREEN = IntArray(256) { it * 587 }
+private val LUMA_BLUE = IntArray(256) { it * 114 }
+
 val getDisplayMaxHeightInPx: Int
     get() = Resources.getSystem().displayMetrics.let { max(it.heightPixels, it.widthPixels) }
@@ -26,6 +26,12 @@ android {
                 schemaOutputDirectory.set(project.file("./src/main/sqldelight-ocr"))
                 srcDirs.setFrom("src/main/sqldelight-ocr")
             }
+            create("PanelCacheDatabase") {
+                packageName.set("tachiyomi.data.panel")
+                dialect(libs.sqldelight.dialects.sql)
+                schemaOutputDirectory.set(project.file("./src/main/sqldelight-panel"))
+                srcDirs.setFrom("src/main/sqldelight-panel")
+            }
         }
     }
 }
@@ -50,6 +56,7 @@ dependencies {
 
     testImplementation(libs.bundles.test)
     testImplementation(kotlinx.coroutines.test)
+    testImplementation(libs.okhttp.mockwebserver)
     testRuntimeOnly(libs.junit.platform.launcher)
 
     androidTestImplementation(androidx.test.ext)
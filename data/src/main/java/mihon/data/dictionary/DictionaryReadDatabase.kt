@@ -0,0 +1,44 @@
+package mihon.data.dictionary
+
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.withContext
+import tachiyomi.data.Database
+
+/**
+ * Access to the main database for legacy dictionary lookups. Callers only read through it; SQLite
+ * does not enforce that.
+ *
+ * It is backed by its own WAL connection pool, separate from the single [tachiyomi.data.DatabaseHandler]
+ * connection. Long dictionary scans therefore run concurrently with each other and never queue
+ * behind library or reader traffic.
+ */
+class DictionaryReadDatabase(
+    openDatabase: () -> Database,
+    parallelism: Int = DEFAULT_PARALLELISM,
+) {
+    private val database by lazy(openDatabase)
+
+    // Matches the connection pool size; more workers would only wait for a connection.
+    private val dispatcher = Dispatchers.IO.limitedParallelism(parallelism)
+
+    suspend fun <T> read(block: Database.() -> T): T {
+        return withContext(dispatcher) { database.block() }
+    }
+
+    /** Runs [block] for every key concurrently and returns the results in [keys] order. */
+    suspend fun <K, T> readEach(keys: List<K>, block: Database.(K) -> T): List<T> {
+        if (keys.size <= 1) {
+            return keys.map { key -> read { block(key) } }
+        }
+        return coroutineScope {
+            keys.map { key -> async(dispatcher) { database.block(key) } }.awaitAll()
+        }
+    }
+
+    companion object {
+        const val DEFAULT_PARALLELISM = 4
+    }
+}
@@ -22,9 +22,11 @@ import mihon.domain.dictionary.repository.DictionaryMigrationStatusRepository
 import mihon.domain.dictionary.repository.DictionaryRepository
 import tachiyomi.core.common.util.system.logcat
 import tachiyomi.data.DatabaseHandler
+import tachiyomi.data.Dictionary_terms
 
 class DictionaryRepositoryImpl(
     private val handler: DatabaseHandler,
+    private val readDatabase: DictionaryReadDatabase,
 ) : DictionaryRepository, DictionaryLegacyRepository, DictionaryMigrationStatusRepository {
 
     private val hoshi by lazy { HoshiDicts() }
@@ -231,15 +233,69 @@ class DictionaryRepositoryImpl(
     }
 
     override suspend fun searchTerms(query: String, dictionaryIds: List<Long>): List<DictionaryTerm> {
-        return handler.awaitList {
+        val rankedDictionaryIds = getEnabledDictionaryIdsByPriority(dictionaryIds)
+        val termsByRank = readDatabase.readEach(rankedDictionaryIds) { dictionaryId ->
             dictionaryQueries.searchTerms(
                 query = query,
-                dictionaryIds = dictionaryIds,
-                limit = 100,
+                dictionaryIds = listOf(dictionaryId),
+                limit = SEARCH_RESULT_LIMIT.toLong(),
+            ).executeAsList()
+        }
+
+        // Same order the single-query form used: expression matches, dictionary priority, score.
+        return termsByRank
+            .flatMapIndexed { rank, terms -> terms.map { rank to it } }
+            .sortedWith(
+                compareBy<Pair<Int, Dictionary_terms>>(
+                    { (_, term) -> if (term.expression == query) 0 else 1 },
+                    { (rank, _) -> rank },
+                    { (_, term) -> -term.score },
+                ),
             )
-        }.map { term ->
-            logcat { "Legacy Term Search: ${term.expression} | ${term.glossary}" }
-            term.toDomain()
+            .take(SEARCH_RESULT_LIMIT)
+            .map { (_, term) ->
+                logcat { "Legacy Term Search: ${term.expression} | ${term.glossary}" }
+                term.toDomain()
+            }
+    }
+
+    override suspend fun searchTermsForQueries(
+        queries: List<String>,
+        dictionaryIds: List<Long>,
+    ): Map<String, List<DictionaryTerm>> {
+        val distinctQueries = queries.distinct()
+        if (distinctQueries.isEmpty()) return emptyMap()
+
+        // Per-dictionary results come back in priority order, each already sorted by score.
+        val rankedDictionaryIds = getEnabledDictionaryIdsByPriority(dictionaryIds)
+        val rows = readDatabase.readEach(rankedDictionaryIds) { dictionaryId ->
+            // A term can match one chunk by expression and another by reading; keep it once.
+            // Each chunk is sorted by score on its own, so the merged rows are re-sorted.
+            distinctQueries.chunked(MAX_QUERIES_PER_BATCH).flatMap { chunk ->
+                dictionaryQueries.searchTermsForQueries(
+                    queries = chunk,
+                    dictionaryIds = listOf(dictionaryId),
+                ).executeAsList()
+            }
+                .distinctBy { it._id }
+                .sortedByDescending { it.score }
+        }
+        val terms = rows.flatten().map { it.toDomain() }
+        val byExpression = terms.groupBy { it.expression }
+        val byReading = terms.groupBy { it.reading }
+
+        // Mirror searchTerms: expression matches first, then reading-only matches, capped per query.
+        return distinctQueries.associateWith { query ->
+            val expressionMatches = byExpression[query].orEmpty()
+            val readingMatches = byReading[query].orEmpty().filter { it.expression != query }
+            (expressionMatches + readingMatches).take(SEARCH_RESULT_LIMIT)
+        }
+    }
+
+    private suspend fun getEnabledDictionaryIdsByPriority(dictionaryIds: List<Long>): List<Long> {
+        if (dictionaryIds.isEmpty()) return emptyList()
+        return readDatabase.read {
+            dictionaryQueries.getEnabledDictionaryIdsByPriority(dictionaryIds).executeAsList()
         }
     }
 
@@ -514,5 +570,9 @@ class DictionaryRepositoryImpl(
     private companion object {
         const val FREQ_MODE = "freq"
         const val MIN_FREQ_ENTRY_COUNT = 5
+        const val SEARCH_RESULT_LIMIT = 100
+
+        // Each query is bound twice (expression and reading), so keep well under SQLite's variable limit.
+        const val MAX_QUERIES_PER_BATCH = 200
     }
 }
@@ -34,6 +34,36 @@ class DictionarySearchGatewayImpl(
         }
     }
 
+    override suspend fun exactSearchMany(
+        expressions: List<String>,
+        dictionaryIds: List<Long>,
+    ): Map<String, List<DictionarySearchEntry>> {
+        val distinctExpressions = expressions.distinct()
+        if (distinctExpressions.isEmpty()) return emptyMap()
+        if (dictionaryIds.isEmpty()) {
+            return distinctExpressions.associateWith { emptyList() }
+        }
+
+        val partition = partitionDictionaryIds(dictionaryIds)
+        val legacyMatches = if (partition.legacyIds.isNotEmpty()) {
+            dictionaryRepository.searchTermsForQueries(distinctExpressions, partition.legacyIds)
+        } else {
+            emptyMap()
+        }
+        val hoshiMatches = if (partition.hoshiIds.isNotEmpty()) {
+            dictionarySearchBackend.exactSearchMany(distinctExpressions, partition.hoshiIds)
+        } else {
+            emptyMap()
+        }
+
+        return distinctExpressions.associateWith { expression ->
+            buildList {
+                legacyMatches[expression].orEmpty().forEach { add(DictionarySearchEntry(it, emptyList())) }
+                addAll(hoshiMatches[expression].orEmpty())
+            }
+        }
+    }
+
     override suspend fun lookup(
         text: String,
         dictionaryIds: List<Long>,
@@ -4,15 +4,22 @@ import android.app.Application
 import de.manhhao.hoshi.HoshiDicts
 import de.manhhao.hoshi.LookupResult
 import de.manhhao.hoshi.TermResult
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.launch
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
 import kotlinx.serialization.json.buildJsonArray
 import kotlinx.serialization.json.buildJsonObject
 import kotlinx.serialization.json.put
+import logcat.LogPriority
+import mihon.domain.dictionary.interactor.DictionarySearchCache
 import mihon.domain.dictionary.model.Dictionary
 import mihon.domain.dictionary.model.DictionaryBackend
+import mihon.domain.dictionary.model.DictionaryGlossary
 import mihon.domain.dictionary.model.DictionaryTerm
 import mihon.domain.dictionary.model.DictionaryTermMeta
 import mihon.domain.dictionary.model.GlossaryEntry
@@ -27,23 +34,40 @@ import mihon.domain.dictionary.service.DictionaryStorageImportOutcome
 import tachiyomi.core.common.util.system.logcat
 import java.io.File
 import java.text.Normalizer
+import java.util.BitSet
+import java.util.concurrent.ConcurrentHashMap
 import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicInteger
 
 class HoshiDictionaryStore(
     private val application: Application,
     private val dictionaryRepository: DictionaryRepository,
     private val dictionaryParser: DictionaryParser,
+    private val searchCache: DictionarySearchCache,
 ) : DictionarySearchBackend, DictionaryStorageGateway {
     private val hoshi = HoshiDicts()
     private val rebuildMutex = Mutex()
     private val dirty = AtomicBoolean(true)
+    private val rebuildScheduled = AtomicBoolean(false)
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
 
     @Volatile
     private var sessionState: SessionState? = null
 
+    private val glossaryCache = object : LinkedHashMap<Long, DecodedGlossary>(
+        GLOSSARY_CACHE_CAPACITY,
+        0.75f,
+        true,
+    ) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<Long, DecodedGlossary>?): Boolean {
+            return size > GLOSSARY_CACHE_CAPACITY
+        }
+    }
+
     override suspend fun refreshSearchSession() {
         dirty.set(true)
         rebuildInternal(force = true)
+        searchCache.invalidate()
     }
 
     private fun getDictionaryStorageParent(dictionaryId: Long): File {
@@ -92,6 +116,7 @@ class HoshiDictionaryStore(
             getDictionaryStorageParent(dictionaryId).deleteRecursively()
         }
         dirty.set(true)
+        searchCache.invalidate()
     }
 
     override suspend fun exactSearch(
@@ -100,15 +125,36 @@ class HoshiDictionaryStore(
     ): List<DictionarySearchEntry> = withContext(Dispatchers.IO) {
         if (dictionaryIds.isEmpty()) return@withContext emptyList()
 
-        val state = ensureSession()
-        if (state.handle == 0L) return@withContext emptyList()
+        withSession(emptyList()) { state ->
+            val results = hoshi.queryExact(state.handle.id, expression)
+            mapTermResults(
+                termResults = results.toList(),
+                allowed = state.allowed(dictionaryIds),
+                state = state,
+            )
+        }
+    }
 
-        val results = hoshi.queryExact(state.handle, expression)
-        mapTermResults(
-            termResults = results.toList(),
-            allowedDictionaryIds = dictionaryIds.toSet(),
-            state = state,
-        )
+    override suspend fun exactSearchMany(
+        expressions: List<String>,
+        dictionaryIds: List<Long>,
+    ): Map<String, List<DictionarySearchEntry>> = withContext(Dispatchers.IO) {
+        val distinctExpressions = expressions.distinct()
+        if (distinctExpressions.isEmpty()) return@withContext emptyMap()
+        val emptyResult = distinctExpressions.associateWith { emptyList<DictionarySearchEntry>() }
+        if (dictionaryIds.isEmpty()) return@withContext emptyResult
+
+        // One dispatcher hop and one session snapshot for the whole batch.
+        withSession(emptyResult) { state ->
+            val allowed = state.allowed(dictionaryIds)
+            distinctExpressions.associateWith { expression ->
+                mapTermResults(
+                    termResults = hoshi.queryExact(state.handle.id, expression).toList(),
+                    allowed = allowed,
+                    state = state,
+                )
+            }
+        }
     }
 
     override suspend fun getTermMeta(
@@ -116,30 +162,26 @@ class HoshiDictionaryStore(
         dictionaryIds: List<Long>,
     ): Map<String, List<DictionaryTermMeta>> = withContext(Dispatchers.IO) {
         if (expressions.isEmpty()) return@withContext emptyMap()
-        if (dictionaryIds.isEmpty()) {
-            return@withContext expressions.associateWith { emptyList() }
-        }
-
-        val state = ensureSession()
-        if (state.handle == 0L) {
-            return@withContext expressions.associateWith { emptyList() }
-        }
-
-        val allowedDictionaryIds = dictionaryIds.toSet()
-        expressions.associateWith { expression ->
-            hoshi.queryExact(state.handle, expression)
-                .toList()
-                .asSequence()
-                .filter { it.expression == expression }
-                .flatMap { termResult ->
-                    buildMetaByDictionaryId(
-                        termResult = termResult,
-                        allowedDictionaryIds = allowedDictionaryIds,
-                        state = state,
-                    ).values.flatten()
-                }
-                .distinctBy(::metaKey)
-                .toList()
+        val emptyResult = expressions.associateWith { emptyList<DictionaryTermMeta>() }
+        if (dictionaryIds.isEmpty()) return@withContext emptyResult
+
+        withSession(emptyResult) { state ->
+            val allowed = state.allowed(dictionaryIds)
+            expressions.associateWith { expression ->
+                hoshi.queryExact(state.handle.id, expression)
+                    .toList()
+                    .asSequence()
+                    .filter { it.expression == expression }
+                    .flatMap { termResult ->
+                        buildMetaByDictionaryId(
+                            termResult = termResult,
+                            allowed = allowed,
+                            state = state,
+                        ).values.flatten()
+                    }
+                    .distinctBy(::metaKey)
+                    .toList()
+            }
         }
     }
 
@@ -150,24 +192,63 @@ class HoshiDictionaryStore(
     ): List<DictionaryLookupMatch> = withContext(Dispatchers.IO) {
         if (dictionaryIds.isEmpty()) return@withContext emptyList()
 
-        val state = ensureSession()
-        if (state.handle == 0L) return@withContext emptyList()
+        withSession(emptyList()) { state ->
+            val allowed = state.allowed(dictionaryIds)
+            hoshi.lookup(state.handle.id, text, maxResults).flatMap { result ->
+                mapLookupResult(
+                    lookupResult = result,
+                    allowed = allowed,
+                    state = state,
+                )
+            }
+        }
+    }
 
-        hoshi.lookup(state.handle, text, maxResults).flatMap { result ->
-            mapLookupResult(
-                lookupResult = result,
-                allowedDictionaryIds = dictionaryIds.toSet(),
-                state = state,
-            )
+    /**
+     * Runs [block] against the current session while holding a reference to its native handle.
+     * A concurrent rebuild may publish a replacement at any time; the old handle is only destroyed
+     * once the last lookup using it has released it.
+     */
+    private suspend fun <T> withSession(empty: T, block: (SessionState) -> T): T {
+        while (true) {
+            val state = ensureSession()
+            if (state.handle.id == 0L) return empty
+            // Retired between reading the session and acquiring it; pick up the replacement.
+            if (!state.handle.acquire()) continue
+            try {
+                return block(state)
+            } finally {
+                releaseHandle(state.handle)
+            }
         }
     }
 
+    /**
+     * Returns the published session without waiting for rebuilds. A dirty session keeps serving
+     * lookups while its replacement is built in the background; only the very first lookup waits.
+     */
     private suspend fun ensureSession(): SessionState {
-        val current = sessionState
-        if (current != null && !dirty.get()) {
-            return current
+        val current = sessionState ?: return rebuildInternal(force = false)
+        if (dirty.get()) {
+            scheduleRebuild()
+        }
+        return current
+    }
+
+    private fun scheduleRebuild() {
+        if (!rebuildScheduled.compareAndSet(false, true)) return
+        scope.launch {
+            try {
+                rebuildInternal(force = false)
+            } catch (e: CancellationException) {
+                throw e
+            } catch (e: Throwable) {
+                // The current session keeps serving lookups; the next one schedules another attempt.
+                logcat(LogPriority.ERROR, e) { "Failed to rebuild Hoshi dictionary session" }
+            } finally {
+                rebuildScheduled.set(false)
+            }
         }
-        return rebuildInternal(force = false)
     }
 
     private suspend fun rebuildInternal(force: Boolean): SessionState = rebuildMutex.withLock {
@@ -175,7 +256,19 @@ class HoshiDictionaryStore(
         if (!force && existing != null && !dirty.get()) {
             return existing
         }
+        // Cleared before reading the dictionaries so changes made during the build mark it dirty again,
+        // and set again if the build fails so the next lookup retries it.
+        dirty.set(false)
+        try {
+            buildSession(existing, force)
+        } catch (e: Throwable) {
+            dirty.set(true)
+            throw e
+        }
+    }
 
+    /** Caller holds [rebuildMutex]. */
+    private suspend fun buildSession(existing: SessionState?, force: Boolean): SessionState {
         val dictionaries = dictionaryRepository.getAllDictionaries()
             .filter {
                 it.backend == DictionaryBackend.HOSHI &&
@@ -184,39 +277,57 @@ class HoshiDictionaryStore(
                     hasHoshiStorageMarker(it.storagePath!!)
             }
             .sortedWith(compareBy<Dictionary> { it.priority }.thenBy { it.title })
-
-        val newHandle = hoshi.createLookupObject()
-        if (dictionaries.isNotEmpty()) {
-            val paths = dictionaries.mapNotNull { it.storagePath }.toTypedArray()
-            hoshi.rebuildQuery(newHandle, paths, paths, paths)
+        val paths = dictionaries.mapNotNull { it.storagePath }
+
+        // The native session only depends on the ordered storage paths. When those are unchanged
+        // (title edits, enable toggles, legacy-only changes) keep the open handle instead of reopening
+        // every dictionary. Forced rebuilds always reopen, since an import may rewrite a path in place.
+        val handle = if (!force && existing != null && existing.paths == paths) {
+            existing.handle
+        } else {
+            LookupHandle(hoshi.createLookupObject()).also { created ->
+                if (paths.isNotEmpty() && created.id != 0L) {
+                    val pathArray = paths.toTypedArray()
+                    try {
+                        hoshi.rebuildQuery(created.id, pathArray, pathArray, pathArray)
+                    } catch (e: Throwable) {
+                        releaseHandle(created)
+                        throw e
+                    }
+                }
+            }
         }
 
         val newState = SessionState(
-            handle = newHandle,
-            dictionariesByTitle = dictionaries.groupBy { it.title },
-            dictionariesByNormalizedTitle = dictionaries.groupBy { normalizeDictionaryTitle(it.title) },
+            handle = handle,
+            paths = paths,
+            dictionaries = dictionaries,
         )
 
         sessionState = newState
-        dirty.set(false)
 
-        existing?.let { old ->
-            if (old.handle != 0L) {
-                hoshi.destroyLookupObject(old.handle)
-            }
+        if (existing != null && existing.handle !== handle) {
+            // Drop the published reference; in-flight lookups keep the old handle alive until they finish.
+            releaseHandle(existing.handle)
         }
 
         return newState
     }
 
+    private fun releaseHandle(handle: LookupHandle) {
+        if (handle.release() && handle.id != 0L) {
+            hoshi.destroyLookupObject(handle.id)
+        }
+    }
+
     private fun mapLookupResult(
         lookupResult: LookupResult,
-        allowedDictionaryIds: Set<Long>,
+        allowed: AllowedDictionaries,
         state: SessionState,
     ): List<DictionaryLookupMatch> {
         return mapTermResult(
             termResult = lookupResult.term,
-            allowedDictionaryIds = allowedDictionaryIds,
+            allowed = allowed,
             state = state,
         ).map { entry ->
             DictionaryLookupMatch(
@@ -231,13 +342,13 @@ class HoshiDictionaryStore(
 
     private fun mapTermResults(
         termResults: List<TermResult>,
-        allowedDictionaryIds: Set<Long>,
+        allowed: AllowedDictionaries,
         state: SessionState,
     ): List<DictionarySearchEntry> {
         return termResults.flatMap { termResult ->
             mapTermResult(
                 termResult = termResult,
-                allowedDictionaryIds = allowedDictionaryIds,
+                allowed = allowed,
                 state = state,
             )
         }
@@ -245,32 +356,25 @@ class HoshiDictionaryStore(
 
     private fun mapTermResult(
         termResult: TermResult,
-        allowedDictionaryIds: Set<Long>,
+        allowed: AllowedDictionaries,
         state: SessionState,
     ): List<DictionarySearchEntry> {
-        val metaByDictionaryId = buildMetaByDictionaryId(termResult, allowedDictionaryIds, state)
+        val metaByDictionaryId = buildMetaByDictionaryId(termResult, allowed, state)
 
         return termResult.glossaries.mapNotNull { glossaryEntry ->
-            val dictionaryId = resolveDictionaryId(
-                title = glossaryEntry.dictName,
-                allowedDictionaryIds = allowedDictionaryIds,
-                state = state,
-            ) ?: return@mapNotNull null
+            val dictionaryId = state.resolve(glossaryEntry.dictName, allowed) ?: return@mapNotNull null
 
+            val termId = syntheticTermId(dictionaryId, termResult, glossaryEntry.glossary)
             DictionarySearchEntry(
                 term = DictionaryTerm(
-                    id = syntheticTermId(dictionaryId, termResult, glossaryEntry.glossary),
+                    id = termId,
                     dictionaryId = dictionaryId,
                     expression = termResult.expression,
                     reading = termResult.reading,
                     definitionTags = glossaryEntry.definitionTags.ifBlank { null },
                     rules = termResult.rules.ifBlank { null },
                     score = termResult.score,
-                    glossary = parseGlossary(glossaryEntry.glossary).also {
-                        logcat {
-                            "Hoshi Glossary: ${glossaryEntry.dictName} | ${termResult.expression} | ${glossaryEntry.glossary}"
-                        }
-                    },
+                    glossarySource = lazyGlossary(termId, glossaryEntry.glossary),
                     sequence = null,
                     termTags = glossaryEntry.termTags.ifBlank { null },
                 ),
@@ -281,14 +385,13 @@ class HoshiDictionaryStore(
 
     private fun buildMetaByDictionaryId(
         termResult: TermResult,
-        allowedDictionaryIds: Set<Long>,
+        allowed: AllowedDictionaries,
         state: SessionState,
     ): Map<Long, List<DictionaryTermMeta>> {
         val grouped = linkedMapOf<Long, MutableList<DictionaryTermMeta>>()
 
         termResult.frequencies.forEach { entry ->
-            val dictionaryId = resolveDictionaryId(entry.dictName, allowedDictionaryIds, state)
-                ?: return@forEach
+            val dictionaryId = state.resolve(entry.dictName, allowed) ?: return@forEach
             val list = grouped.getOrPut(dictionaryId) { mutableListOf() }
             entry.frequencies.forEach { frequency ->
                 list += DictionaryTermMeta(
@@ -305,7 +408,7 @@ class HoshiDictionaryStore(
         }
 
         termResult.pitches.forEach { entry ->
-            val dictionaryId = resolveDictionaryId(entry.dictName, allowedDictionaryIds, state) ?: return@forEach
+            val dictionaryId = state.resolve(entry.dictName, allowed) ?: return@forEach
             val list = grouped.getOrPut(dictionaryId) { mutableListOf() }
             list += DictionaryTermMeta(
                 dictionaryId = dictionaryId,
@@ -321,31 +424,6 @@ class HoshiDictionaryStore(
         return grouped
     }
 
-    private fun resolveDictionaryId(
-        title: String,
-        allowedDictionaryIds: Set<Long>,
-        state: SessionState,
-    ): Long? {
-        val exactMatch = state.dictionariesByTitle[title]
-            ?.firstOrNull { it.id in allowedDictionaryIds }
-            ?.id
-        if (exactMatch != null) {
-            return exactMatch
-        }
-
-        val normalizedTitle = normalizeDictionaryTitle(title)
-        return state.dictionariesByNormalizedTitle[normalizedTitle]
-            ?.firstOrNull { it.id in allowedDictionaryIds }
-            ?.id
-    }
-
-    private fun normalizeDictionaryTitle(title: String): String {
-        return Normalizer.normalize(title, Normalizer.Form.NFKC)
-            .trim()
-            .replace(WHITESPACE_REGEX, " ")
-            .lowercase()
-    }
-
     private suspend fun assertUniqueDictionaryTitle(dictionaryId: Long, dictionaryTitle: String) {
         val normalizedTitle = normalizeDictionaryTitle(dictionaryTitle)
         check(
@@ -356,6 +434,24 @@ class HoshiDictionaryStore(
         ) { "Dictionary title conflicts with an existing Hoshidicts-backed identity: $dictionaryTitle" }
     }
 
+    /**
+     * Defers glossary decoding until the term is rendered. Decoded glossaries are kept in a
+     * bounded LRU keyed by the synthetic term id, so repeated lookups of the same term reuse them.
+     */
+    private fun lazyGlossary(termId: Long, rawGlossary: String): DictionaryGlossary {
+        if (rawGlossary.isBlank()) return DictionaryGlossary.of(emptyList())
+
+        return DictionaryGlossary.lazy(key = rawGlossary) {
+            // Synthetic ids are hashes, so confirm the raw payload before trusting a cached entry.
+            synchronized(glossaryCache) { glossaryCache[termId] }
+                ?.takeIf { it.raw == rawGlossary }
+                ?.entries
+                ?: parseGlossary(rawGlossary).also { decoded ->
+                    synchronized(glossaryCache) { glossaryCache[termId] = DecodedGlossary(rawGlossary, decoded) }
+                }
+        }
+    }
+
     private fun parseGlossary(rawGlossary: String): List<GlossaryEntry> {
         if (rawGlossary.isBlank()) return emptyList()
 
@@ -398,14 +494,98 @@ class HoshiDictionaryStore(
         return -raw.hashCode().toLong()
     }
 
-    private data class SessionState(
-        val handle: Long,
-        val dictionariesByTitle: Map<String, List<Dictionary>>,
-        val dictionariesByNormalizedTitle: Map<String, List<Dictionary>>,
+    private class DecodedGlossary(
+        val raw: String,
+        val entries: List<GlossaryEntry>,
     )
 
+    /**
+     * Reference-counted native lookup object. The published session owns one reference and every
+     * in-flight lookup holds another.
+     */
+    private class LookupHandle(val id: Long) {
+        private val refs = AtomicInteger(1)
+
+        fun acquire(): Boolean {
+            while (true) {
+                val current = refs.get()
+                if (current <= 0) return false
+                if (refs.compareAndSet(current, current + 1)) return true
+            }
+        }
+
+        /** Returns `true` when the last reference was released and the native object can be destroyed. */
+        fun release(): Boolean = refs.decrementAndGet() == 0
+    }
+
+    /** Dictionaries a lookup may return, as a bitset over [SessionState]'s dense indices. */
+    private class AllowedDictionaries(
+        val dictionaryIds: List<Long>,
+        val indices: BitSet,
+    )
+
+    /**
+     * A published lookup session. Session dictionaries get dense indices in priority order, and
+     * native dictionary names are resolved to candidate indices once per session instead of once
+     * per glossary/meta entry.
+     */
+    private class SessionState(
+        val handle: LookupHandle,
+        val paths: List<String>,
+        dictionaries: List<Dictionary>,
+    ) {
+        private val dictionaryIds = LongArray(dictionaries.size) { dictionaries[it].id }
+        private val indicesByTitle = indexBy(dictionaries) { it.title }
+        private val indicesByNormalizedTitle = indexBy(dictionaries) { normalizeDictionaryTitle(it.title) }
+        private val resolvedTitles = ConcurrentHashMap<String, ResolvedTitle>()
+
+        // Callers pass the same enabled-dictionary list on every lookup, so the last bitset is reused.
+        @Volatile
+        private var lastAllowed: AllowedDictionaries? = null
+
+        fun allowed(ids: List<Long>): AllowedDictionaries {
+            lastAllowed?.takeIf { it.dictionaryIds == ids }?.let { return it }
+
+            val wanted = ids.toHashSet()
+            val indices = BitSet(dictionaryIds.size)
+            dictionaryIds.forEachIndexed { index, id -> if (id in wanted) indices.set(index) }
+            return AllowedDictionaries(ids, indices).also { lastAllowed = it }
+        }
+
+        /** Exact title matches win over normalized ones, matching how titles are kept unique on import. */
+        fun resolve(title: String, allowed: AllowedDictionaries): Long? {
+            val resolved = resolvedTitles.getOrPut(title) {
+                ResolvedTitle(
+                    exact = indicesByTitle[title] ?: EMPTY_INDICES,
+                    normalized = indicesByNormalizedTitle[normalizeDictionaryTitle(title)] ?: EMPTY_INDICES,
+                )
+            }
+            val index = resolved.exact.firstOrNull { allowed.indices[it] }
+                ?: resolved.normalized.firstOrNull { allowed.indices[it] }
+                ?: return null
+            return dictionaryIds[index]
+        }
+
+        private class ResolvedTitle(val exact: IntArray, val normalized: IntArray)
+
+        private fun indexBy(dictionaries: List<Dictionary>, key: (Dictionary) -> String): Map<String, IntArray> {
+            return dictionaries.indices
+                .groupBy { key(dictionaries[it]) }
+                .mapValues { (_, indices) -> indices.toIntArray() }
+        }
+    }
+
     companion object {
         private val WHITESPACE_REGEX = Regex("\\s+")
+        private const val GLOSSARY_CACHE_CAPACITY = 512
+        private val EMPTY_INDICES = IntArray(0)
+
+        private fun normalizeDictionaryTitle(title: String): String {
+            return Normalizer.normalize(title, Normalizer.Form.NFKC)
+                .trim()
+                .replace(WHITESPACE_REGEX, " ")
+                .lowercase()
+        }
 
         private fun metaKey(meta: DictionaryTermMeta): String {
             return "${meta.dictionaryId}|${meta.expression}|${meta.mode}|${meta.data}"
@@ -0,0 +1,38 @@
+package mihon.data.ocr
+
+import android.graphics.Bitmap
+import mihon.domain.ocr.model.OcrImage
+
+/**
+ * [OcrImage] backed directly by a decoded [Bitmap], so OCR engines read the page pixels without
+ * an intermediate [IntArray] copy.
+ *
+ * @param recycleOnRelease whether releasing the last reference also recycles [bitmap]; pass
+ * `false` when the caller keeps using the bitmap afterwards.
+ */
+class BitmapOcrImage(
+    val bitmap: Bitmap,
+    private val recycleOnRelease: Boolean = true,
+) : OcrImage(bitmap.width, bitmap.height) {
+
+    override fun copyPixels(): IntArray {
+        val pixels = IntArray(width * height)
+        if (bitmap.config == Bitmap.Config.HARDWARE) {
+            val readable = bitmap.copy(Bitmap.Config.ARGB_8888, false)
+            try {
+                readable.getPixels(pixels, 0, width, 0, 0, width, height)
+            } finally {
+                readable.recycle()
+            }
+        } else {
+            bitmap.getPixels(pixels, 0, width, 0, 0, width, height)
+        }
+        return pixels
+    }
+
+    override fun onReleased() {
+        if (recycleOnRelease && !bitmap.isRecycled) {
+            bitmap.recycle()
+        }
+    }
+}
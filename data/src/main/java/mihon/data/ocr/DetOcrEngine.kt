@@ -3,15 +3,17 @@ package mihon.data.ocr
 import android.graphics.Bitmap
 import mihon.domain.ocr.exception.OcrException
 import mihon.domain.ocr.model.OcrBoundingBox
+import tachiyomi.core.common.util.system.ReadingDirection
 
 internal interface DetOcrEngine {
-    suspend fun detectTextRegions(image: Bitmap): List<OcrBoundingBox>
+    /** Returns the text regions of [image] as page-relative boxes, ordered for [direction]. */
+    suspend fun detectTextRegions(image: Bitmap, direction: ReadingDirection): List<OcrBoundingBox>
 
     fun close()
 }
 
 internal class UnavailableDetOcrEngine : DetOcrEngine {
-    override suspend fun detectTextRegions(image: Bitmap): List<OcrBoundingBox> {
+    override suspend fun detectTextRegions(image: Bitmap, direction: ReadingDirection): List<OcrBoundingBox> {
         throw OcrException.DetectionUnavailable()
     }
 
@@ -0,0 +1,82 @@
+package mihon.data.ocr
+
+import android.graphics.Bitmap
+import android.os.Build
+
+/**
+ * How [GlensOcrEngine] encodes page images before upload.
+ *
+ * [AUTO] keeps clean line art lossless, where PNG is compact and JPEG would ring around glyph edges,
+ * and sends scanned or shaded pages as JPEG, which is several times smaller and faster to encode.
+ */
+internal enum class GlensImageEncoding {
+    AUTO,
+    PNG,
+    JPEG,
+    WEBP,
+    ;
+
+    fun resolve(bitmap: Bitmap): Format {
+        return when (this) {
+            AUTO -> if (isFlatArtwork(samplePixels(bitmap))) PNG.resolve(bitmap) else JPEG.resolve(bitmap)
+            PNG -> Format(Bitmap.CompressFormat.PNG, 100)
+            JPEG -> Format(Bitmap.CompressFormat.JPEG, LOSSY_QUALITY)
+            WEBP -> if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+                Format(Bitmap.CompressFormat.WEBP_LOSSY, LOSSY_QUALITY)
+            } else {
+                JPEG.resolve(bitmap)
+            }
+        }
+    }
+
+    data class Format(
+        val compressFormat: Bitmap.CompressFormat,
+        val quality: Int,
+    ) {
+        override fun toString(): String = "$compressFormat@$quality"
+    }
+
+    companion object {
+        // High enough that small furigana survive; text legibility drops off quickly below ~85.
+        private const val LOSSY_QUALITY = 90
+
+        private const val SAMPLE_ROWS = 48
+        private const val SAMPLE_COLUMNS = 64
+        private const val MIDTONE_MIN = 48
+        private const val MIDTONE_MAX = 208
+        private const val FLAT_MIDTONE_RATIO = 0.08f
+
+        /**
+         * Returns true when almost every pixel is near black or near white, i.e. digital line art
+         * rather than a scan or a toned page.
+         */
+        fun isFlatArtwork(pixels: IntArray): Boolean {
+            if (pixels.isEmpty()) return true
+            var midtones = 0
+            for (pixel in pixels) {
+                val r = (pixel shr 16) and 0xFF
+                val g = (pixel shr 8) and 0xFF
+                val b = pixel and 0xFF
+                val luma = (r * 299 + g * 587 + b * 114) / 1000
+                if (luma in MIDTONE_MIN..MIDTONE_MAX) midtones++
+            }
+            return midtones < pixels.size * FLAT_MIDTONE_RATIO
+        }
+
+        private fun samplePixels(bitmap: Bitmap): IntArray {
+            val rows = minOf(SAMPLE_ROWS, bitmap.height)
+            val columns = minOf(SAMPLE_COLUMNS, bitmap.width)
+            val row = IntArray(bitmap.width)
+            val samples = IntArray(rows * columns)
+            var index = 0
+            for (r in 0 until rows) {
+                val y = (r * bitmap.height) / rows
+                bitmap.getPixels(row, 0, bitmap.width, 0, y, bitmap.width, 1)
+                for (c in 0 until columns) {
+                    samples[index++] = row[(c * bitmap.width) / columns]
+                }
+            }
+            return samples
+        }
+    }
+}
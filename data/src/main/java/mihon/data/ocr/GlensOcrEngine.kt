@@ -2,26 +2,42 @@ package mihon.data.ocr
 
 import android.graphics.Bitmap
 import androidx.core.graphics.scale
+import eu.kanade.tachiyomi.network.NetworkHelper
+import eu.kanade.tachiyomi.network.await
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.withContext
 import logcat.LogPriority
 import mihon.domain.ocr.model.OcrBoundingBox
 import mihon.domain.ocr.model.OcrRegion
 import mihon.domain.ocr.model.OcrTextOrientation
+import okhttp3.MediaType.Companion.toMediaType
+import okhttp3.OkHttpClient
+import okhttp3.Request
+import okhttp3.RequestBody.Companion.toRequestBody
 import tachiyomi.core.common.util.system.logcat
+import uy.kohesive.injekt.Injekt
+import uy.kohesive.injekt.api.get
 import java.io.ByteArrayOutputStream
 import java.io.IOException
-import java.net.HttpURLConnection
-import java.net.URL
+import java.util.concurrent.TimeUnit
 import kotlin.random.Random
 
 /**
  * OCR engine backed by Google Lens online OCR.
  * Extracts plain text from text-layout boxes in the protobuf response.
  */
-internal class GlensOcrEngine : OcrEngine {
+internal class GlensOcrEngine(
+    baseClient: OkHttpClient = Injekt.get<NetworkHelper>().nonCloudflareClient,
+    private val encoding: GlensImageEncoding = GlensImageEncoding.AUTO,
+) : OcrEngine {
     private val textPostprocessor = TextPostprocessor()
 
+    // Shares the app's connection pool, so consecutive uploads reuse one TLS connection.
+    private val client = baseClient.newBuilder()
+        .connectTimeout(CONNECT_TIMEOUT_MS, TimeUnit.MILLISECONDS)
+        .readTimeout(READ_TIMEOUT_MS, TimeUnit.MILLISECONDS)
+        .build()
+
     override suspend fun recognizeText(image: Bitmap): String = withContext(Dispatchers.IO) {
         require(!image.isRecycled) { "Input bitmap is recycled" }
 
@@ -75,12 +91,16 @@ internal class GlensOcrEngine : OcrEngine {
 
         val working = resized ?: image
         return try {
+            val format = encoding.resolve(working)
             val encoded = ByteArrayOutputStream()
-            val success = working.compress(Bitmap.CompressFormat.PNG, 100, encoded)
+            val success = working.compress(format.compressFormat, format.quality, encoded)
             if (!success) {
                 throw IOException("Failed to encode image for GLens request")
             }
 
+            logcat(LogPriority.DEBUG) {
+                "OCR(glens) encoded ${working.width}x${working.height} as $format: ${encoded.size()} bytes"
+            }
             PreparedImage(
                 bytes = encoded.toByteArray(),
                 width = working.width,
@@ -131,38 +151,23 @@ internal class GlensOcrEngine : OcrEngine {
         }.toByteArray()
     }
 
-    private fun executeRequest(payload: ByteArray): ByteArray {
-        val connection = (URL(LENS_ENDPOINT).openConnection() as HttpURLConnection).apply {
-            requestMethod = "POST"
-            doOutput = true
-            connectTimeout = CONNECT_TIMEOUT_MS
-            readTimeout = READ_TIMEOUT_MS
-            setRequestProperty("Content-Type", CONTENT_TYPE_PROTOBUF)
-            setRequestProperty("User-Agent", DEFAULT_USER_AGENT)
-            setRequestProperty("X-Goog-Api-Key", API_KEY)
-            setRequestProperty("Connection", "keep-alive")
-            setRequestProperty("Sec-Fetch-Mode", "no-cors")
-            setRequestProperty("Sec-Fetch-Dest", "empty")
-        }
+    private suspend fun executeRequest(payload: ByteArray): ByteArray {
+        val request = Request.Builder()
+            .url(LENS_ENDPOINT)
+            .header("User-Agent", DEFAULT_USER_AGENT)
+            .header("X-Goog-Api-Key", API_KEY)
+            .header("Sec-Fetch-Mode", "no-cors")
+            .header("Sec-Fetch-Dest", "empty")
+            .post(payload.toRequestBody(CONTENT_TYPE_PROTOBUF.toMediaType()))
+            .build()
 
-        return try {
-            connection.outputStream.use { output ->
-                output.write(payload)
-            }
-
-            val statusCode = connection.responseCode
-            val responseBytes = (if (statusCode in 200..299) connection.inputStream else connection.errorStream)
-                ?.use { input -> input.readBytes() }
-                ?: ByteArray(0)
-
-            if (statusCode !in 200..299) {
+        return client.newCall(request).await().use { response ->
+            val responseBytes = response.body.bytes()
+            if (!response.isSuccessful) {
                 val bodyPreview = responseBytes.toString(Charsets.UTF_8).take(256)
-                throw IOException("GLens request failed with HTTP $statusCode: $bodyPreview")
+                throw IOException("GLens request failed with HTTP ${response.code}: $bodyPreview")
             }
-
             responseBytes
-        } finally {
-            connection.disconnect()
         }
     }
 
@@ -757,8 +762,8 @@ internal class GlensOcrEngine : OcrEngine {
         private const val DEFAULT_CLIENT_REGION = "Asia/Tokyo"
         private const val MAX_IMAGE_DIMENSION = 1500
 
-        private const val CONNECT_TIMEOUT_MS = 10_000
-        private const val READ_TIMEOUT_MS = 60_000
+        private const val CONNECT_TIMEOUT_MS = 10_000L
+        private const val READ_TIMEOUT_MS = 60_000L
 
         private const val WIRE_TYPE_MASK = 0x7
         private const val WIRE_TYPE_LENGTH_DELIMITED = 2
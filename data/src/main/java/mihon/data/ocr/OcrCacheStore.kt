@@ -21,34 +21,54 @@ internal class OcrCacheStore(
     @Volatile
     private var databaseHandle: DatabaseHandle? = null
 
+    // Immutable per-chapter snapshots read without the mutex; replaced copy-on-write under it.
+    private val chapterIndexes = object : LinkedHashMap<Long, Map<Int, OcrPageResult>>(
+        PREFETCHED_CHAPTERS,
+        0.75f,
+        true,
+    ) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<Long, Map<Int, OcrPageResult>>?): Boolean {
+            return size > PREFETCHED_CHAPTERS
+        }
+    }
+
     suspend fun upsert(pageResult: OcrPageResult) {
+        upsertAll(listOf(pageResult))
+    }
+
+    suspend fun upsertAll(pageResults: List<OcrPageResult>) {
+        if (pageResults.isEmpty()) return
         mutex.withLock {
             val db = getDatabase()
 
             db.transaction {
-                db.ocr_cacheQueries.insertPage(
-                    chapterId = pageResult.chapterId,
-                    pageIndex = pageResult.pageIndex.toLong(),
-                    ocrModel = pageResult.ocrModel.name,
-                    imageWidth = pageResult.imageWidth.toLong(),
-                    imageHeight = pageResult.imageHeight.toLong(),
-                    createdAt = System.currentTimeMillis(),
-                )
-                val pageId = db.ocr_cacheQueries.selectLastInsertedRowId().executeAsOne()
-                pageResult.regions.forEach { region ->
-                    val box = region.boundingBox
-                    db.ocr_cacheQueries.insertRegion(
-                        pageId = pageId,
-                        regionOrder = region.order.toLong(),
-                        leftNorm = box.left.toDouble(),
-                        topNorm = box.top.toDouble(),
-                        rightNorm = box.right.toDouble(),
-                        bottomNorm = box.bottom.toDouble(),
-                        text = region.text,
-                        orientation = region.textOrientation.name,
+                pageResults.forEach { pageResult ->
+                    db.ocr_cacheQueries.insertPage(
+                        chapterId = pageResult.chapterId,
+                        pageIndex = pageResult.pageIndex.toLong(),
+                        ocrModel = pageResult.ocrModel.name,
+                        imageWidth = pageResult.imageWidth.toLong(),
+                        imageHeight = pageResult.imageHeight.toLong(),
+                        createdAt = System.currentTimeMillis(),
+                        contentHash = pageResult.contentHash,
                     )
+                    val pageId = db.ocr_cacheQueries.selectLastInsertedRowId().executeAsOne()
+                    pageResult.regions.forEach { region ->
+                        val box = region.boundingBox
+                        db.ocr_cacheQueries.insertRegion(
+                            pageId = pageId,
+                            regionOrder = region.order.toLong(),
+                            leftNorm = box.left.toDouble(),
+                            topNorm = box.top.toDouble(),
+                            rightNorm = box.right.toDouble(),
+                            bottomNorm = box.bottom.toDouble(),
+                            text = region.text,
+                            orientation = region.textOrientation.name,
+                        )
+                    }
                 }
             }
+            updateIndexes(pageResults)
         }
     }
 
@@ -56,6 +76,9 @@ internal class OcrCacheStore(
         chapterId: Long,
         pageIndex: Int,
     ): OcrPageResult? {
+        // A prefetched chapter is authoritative: every write to it also updates the snapshot.
+        indexFor(chapterId)?.let { pages -> return pages[pageIndex] }
+
         return mutex.withLock {
             val db = getDatabase()
             val page = db.ocr_cacheQueries.getPage(
@@ -72,46 +95,143 @@ internal class OcrCacheStore(
                 )
             }.executeAsOneOrNull() ?: return@withLock null
 
-            val regions = db.ocr_cacheQueries.getRegionsForPage(page.id) {
-                    _id,
-                    _pageId,
-                    regionOrder,
-                    leftNorm,
-                    topNorm,
-                    rightNorm,
-                    bottomNorm,
-                    text,
-                    orientation,
-                ->
-                OcrRegionRow(
+            readPage(db, page)
+        }
+    }
+
+    /**
+     * Loads every cached page of [chapterId] with one query into an in-memory snapshot, so the
+     * reader's per-page lookups skip SQLite and the store mutex entirely.
+     */
+    suspend fun prefetchChapter(chapterId: Long) {
+        if (indexFor(chapterId) != null) return
+        mutex.withLock {
+            if (indexFor(chapterId) != null) return@withLock
+            val db = getDatabase()
+
+            val rows = db.ocr_cacheQueries.getChapterPagesWithRegions(chapterId).executeAsList()
+            val pages = rows
+                .groupBy { it.page_index.toInt() }
+                .mapValues { (pageIndex, pageRows) ->
+                    // Rows are ordered newest first per page; older duplicates are ignored.
+                    val newestPageId = pageRows.first().page_id
+                    val newestRows = pageRows.filter { it.page_id == newestPageId }
+                    val head = newestRows.first()
+                    OcrPageResult(
+                        chapterId = chapterId,
+                        pageIndex = pageIndex,
+                        ocrModel = OcrModel.valueOf(head.ocr_model),
+                        imageWidth = head.image_width.toInt(),
+                        imageHeight = head.image_height.toInt(),
+                        regions = newestRows.mapNotNull { row ->
+                            val regionOrder = row.region_order ?: return@mapNotNull null
+                            OcrRegion(
+                                order = regionOrder.toInt(),
+                                text = row.text!!,
+                                boundingBox = OcrBoundingBox(
+                                    left = row.left_norm!!.toFloat(),
+                                    top = row.top_norm!!.toFloat(),
+                                    right = row.right_norm!!.toFloat(),
+                                    bottom = row.bottom_norm!!.toFloat(),
+                                ),
+                                textOrientation = OcrTextOrientation.valueOf(row.orientation!!),
+                            )
+                        },
+                        contentHash = head.content_hash,
+                    )
+                }
+
+            synchronized(chapterIndexes) {
+                chapterIndexes[chapterId] = pages
+            }
+        }
+    }
+
+    private fun indexFor(chapterId: Long): Map<Int, OcrPageResult>? {
+        return synchronized(chapterIndexes) { chapterIndexes[chapterId] }
+    }
+
+    /** Caller holds [mutex]. */
+    private fun updateIndexes(pageResults: List<OcrPageResult>) {
+        synchronized(chapterIndexes) {
+            pageResults.groupBy(OcrPageResult::chapterId).forEach { (chapterId, results) ->
+                val existing = chapterIndexes[chapterId] ?: return@forEach
+                chapterIndexes[chapterId] = existing + results.associateBy(OcrPageResult::pageIndex)
+            }
+        }
+    }
+
+    private fun dropIndexes(chapterId: Long? = null) {
+        synchronized(chapterIndexes) {
+            if (chapterId == null) chapterIndexes.clear() else chapterIndexes.remove(chapterId)
+        }
+    }
+
+    /** Finds the newest result for an identical image scanned with [ocrModel], in any chapter. */
+    suspend fun getPageByContentHash(
+        contentHash: String,
+        ocrModel: OcrModel,
+    ): OcrPageResult? {
+        return mutex.withLock {
+            val db = getDatabase()
+            val page = db.ocr_cacheQueries.getPageByContentHash(
+                contentHash = contentHash,
+                ocrModel = ocrModel.name,
+            ) { _id, _chapterId, _pageIndex, _ocrModel, imageWidth, imageHeight, _createdAt ->
+                OcrPageRow(
                     id = _id,
-                    pageId = _pageId,
-                    regionOrder = regionOrder.toInt(),
-                    region = OcrRegion(
-                        order = regionOrder.toInt(),
-                        text = text,
-                        boundingBox = OcrBoundingBox(
-                            left = leftNorm.toFloat(),
-                            top = topNorm.toFloat(),
-                            right = rightNorm.toFloat(),
-                            bottom = bottomNorm.toFloat(),
-                        ),
-                        textOrientation = OcrTextOrientation.valueOf(orientation),
-                    ),
+                    chapterId = _chapterId,
+                    pageIndex = _pageIndex.toInt(),
+                    ocrModel = OcrModel.valueOf(_ocrModel),
+                    imageWidth = imageWidth.toInt(),
+                    imageHeight = imageHeight.toInt(),
                 )
-            }.executeAsList()
-
-            OcrPageResult(
-                chapterId = page.chapterId,
-                pageIndex = page.pageIndex,
-                ocrModel = page.ocrModel,
-                imageWidth = page.imageWidth,
-                imageHeight = page.imageHeight,
-                regions = regions.sortedBy(OcrRegionRow::regionOrder).map(OcrRegionRow::region),
-            )
+            }.executeAsOneOrNull() ?: return@withLock null
+
+            readPage(db, page).copy(contentHash = contentHash)
         }
     }
 
+    private fun readPage(db: OcrCacheDatabase, page: OcrPageRow): OcrPageResult {
+        val regions = db.ocr_cacheQueries.getRegionsForPage(page.id) {
+                _id,
+                _pageId,
+                regionOrder,
+                leftNorm,
+                topNorm,
+                rightNorm,
+                bottomNorm,
+                text,
+                orientation,
+            ->
+            OcrRegionRow(
+                id = _id,
+                pageId = _pageId,
+                regionOrder = regionOrder.toInt(),
+                region = OcrRegion(
+                    order = regionOrder.toInt(),
+                    text = text,
+                    boundingBox = OcrBoundingBox(
+                        left = leftNorm.toFloat(),
+                        top = topNorm.toFloat(),
+                        right = rightNorm.toFloat(),
+                        bottom = bottomNorm.toFloat(),
+                    ),
+                    textOrientation = OcrTextOrientation.valueOf(orientation),
+                ),
+            )
+        }.executeAsList()
+
+        return OcrPageResult(
+            chapterId = page.chapterId,
+            pageIndex = page.pageIndex,
+            ocrModel = page.ocrModel,
+            imageWidth = page.imageWidth,
+            imageHeight = page.imageHeight,
+            regions = regions.sortedBy(OcrRegionRow::regionOrder).map(OcrRegionRow::region),
+        )
+    }
+
     suspend fun getCachedChapterIds(
         chapterIds: Collection<Long>,
     ): Set<Long> {
@@ -127,19 +247,58 @@ internal class OcrCacheStore(
         }
     }
 
+    /**
+     * Marks [chapterId] as incomplete for the duration of a scan and returns the scan's start time.
+     * Only complete chapters are reported by [getCachedChapterIds]; pages of incomplete ones are
+     * still served.
+     */
+    suspend fun startChapterScan(chapterId: Long): Long {
+        return mutex.withLock {
+            val db = getDatabase()
+            db.ocr_cacheQueries.markChapterIncomplete(chapterId = chapterId)
+            System.currentTimeMillis()
+        }
+    }
+
+    /**
+     * Marks [chapterId] as complete and deletes its pages that the scan started at [startedAt] did
+     * not rewrite, such as pages past the end of a chapter that came back shorter.
+     */
+    suspend fun finishChapterScan(chapterId: Long, startedAt: Long) {
+        mutex.withLock {
+            dropIndexes(chapterId)
+            val db = getDatabase()
+            db.transaction {
+                db.ocr_cacheQueries.deleteChapterPagesCreatedBefore(
+                    chapterId = chapterId,
+                    createdBefore = startedAt,
+                )
+                db.ocr_cacheQueries.markChapterComplete(
+                    chapterId = chapterId,
+                    completedAt = System.currentTimeMillis(),
+                )
+            }
+        }
+    }
+
     suspend fun clearChapter(
         chapterId: Long,
     ) {
         mutex.withLock {
+            dropIndexes(chapterId)
             val db = getDatabase()
-            db.ocr_cacheQueries.deleteChapterPages(
-                chapterId = chapterId,
-            )
+            db.transaction {
+                db.ocr_cacheQueries.markChapterIncomplete(chapterId = chapterId)
+                db.ocr_cacheQueries.deleteChapterPages(
+                    chapterId = chapterId,
+                )
+            }
         }
     }
 
     suspend fun clear() {
         mutex.withLock {
+            dropIndexes()
             closeDatabaseHandle()
             deleteDatabaseFile()
         }
@@ -204,17 +363,9 @@ internal class OcrCacheStore(
         )
         var shouldDelete = false
         try {
-            database.rawQuery("PRAGMA table_info(ocr_regions)", null).use { cursor ->
-                var hasOrientationColumn = false
-                val nameIndex = cursor.getColumnIndex("name")
-                while (cursor.moveToNext()) {
-                    if (nameIndex >= 0 && cursor.getString(nameIndex) == "orientation") {
-                        hasOrientationColumn = true
-                        break
-                    }
-                }
-                shouldDelete = !hasOrientationColumn
-            }
+            shouldDelete = !database.hasColumn("ocr_regions", "orientation") ||
+                !database.hasColumn("ocr_pages", "content_hash") ||
+                !database.hasTable("ocr_chapters")
         } finally {
             database.close()
         }
@@ -223,6 +374,24 @@ internal class OcrCacheStore(
         }
     }
 
+    private fun SQLiteDatabase.hasTable(table: String): Boolean {
+        rawQuery("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?", arrayOf(table)).use { cursor ->
+            return cursor.moveToFirst()
+        }
+    }
+
+    private fun SQLiteDatabase.hasColumn(table: String, column: String): Boolean {
+        rawQuery("PRAGMA table_info($table)", null).use { cursor ->
+            val nameIndex = cursor.getColumnIndex("name")
+            while (cursor.moveToNext()) {
+                if (nameIndex >= 0 && cursor.getString(nameIndex) == column) {
+                    return true
+                }
+            }
+        }
+        return false
+    }
+
     private fun deleteDatabaseFile() {
         context.deleteDatabase(DB_NAME)
         context.getDatabasePath(DB_NAME).delete()
@@ -263,5 +432,8 @@ internal class OcrCacheStore(
 
     companion object {
         private const val DB_NAME = "ocr_cache.db"
+
+        // Current chapter plus its neighbours, as warmed by the reader.
+        private const val PREFETCHED_CHAPTERS = 3
     }
 }
@@ -0,0 +1,51 @@
+package mihon.data.ocr
+
+import android.graphics.Bitmap
+import java.nio.ByteBuffer
+import java.security.MessageDigest
+
+private const val HASH_GRID_SIZE = 32
+private const val HASH_SAMPLED_ROWS = 256
+
+/**
+ * Hashes the dimensions and a downsampled grid of a page's decoded pixels, so the same image
+ * reached through another chapter, source or rescan maps to the same OCR or panel cache entry
+ * regardless of its container format. Only [HASH_SAMPLED_ROWS] evenly spaced rows are read, and
+ * their channel sums are folded into a [HASH_GRID_SIZE] square grid before hashing.
+ */
+internal fun Bitmap.contentHash(): String {
+    if (config == Bitmap.Config.HARDWARE) {
+        val readable = copy(Bitmap.Config.ARGB_8888, false)
+        try {
+            return readable.contentHash()
+        } finally {
+            readable.recycle()
+        }
+    }
+
+    val gridWidth = minOf(HASH_GRID_SIZE, width)
+    val gridHeight = minOf(HASH_GRID_SIZE, height)
+    val sums = LongArray(gridWidth * gridHeight * 4)
+    val sampledRows = minOf(HASH_SAMPLED_ROWS, height)
+    val row = IntArray(width)
+    for (sample in 0 until sampledRows) {
+        val y = (sample.toLong() * height / sampledRows).toInt()
+        getPixels(row, 0, width, 0, y, width, 1)
+        val cellRow = y * gridHeight / height * gridWidth
+        for (x in 0 until width) {
+            val cell = (cellRow + x * gridWidth / width) * 4
+            val pixel = row[x]
+            sums[cell] += (pixel ushr 24 and 0xFF).toLong()
+            sums[cell + 1] += (pixel ushr 16 and 0xFF).toLong()
+            sums[cell + 2] += (pixel ushr 8 and 0xFF).toLong()
+            sums[cell + 3] += (pixel and 0xFF).toLong()
+        }
+    }
+
+    val buffer = ByteBuffer.allocate(Int.SIZE_BYTES * 2 + sums.size * Long.SIZE_BYTES)
+    buffer.putInt(width).putInt(height)
+    sums.forEach(buffer::putLong)
+    return MessageDigest.getInstance("SHA-1")
+        .digest(buffer.array())
+        .joinToString(separator = "") { "%02x".format(it) }
+}
@@ -14,6 +14,14 @@ internal interface OcrEngine {
      */
     suspend fun recognizeText(image: Bitmap): String
 
+    /**
+     * Recognizes text from several bitmaps, returning results in the same order.
+     * Engines that can amortise setup across images override this; the default runs them one by one.
+     */
+    suspend fun recognizeBatch(images: List<Bitmap>): List<String> {
+        return images.map { recognizeText(it) }
+    }
+
     /**
      * Releases all resources held by this engine.
      */
@@ -1,50 +1,77 @@
 package mihon.data.ocr
 
-import kotlinx.coroutines.sync.Mutex
-import kotlinx.coroutines.sync.withLock
+import kotlinx.coroutines.sync.Semaphore
+import kotlinx.coroutines.sync.withPermit
 
 internal class OcrEngineLocks {
-    private val legacyMutex = Mutex()
-    private val fastMutex = Mutex()
-    private val glensMutex = Mutex()
-    private val owOcrMutex = Mutex()
-    private val detectionMutex = Mutex()
+    private val legacyPermits = Semaphore(concurrencyFor(OcrRepositoryImpl.EngineType.LEGACY))
+    private val fastPermits = Semaphore(concurrencyFor(OcrRepositoryImpl.EngineType.FAST))
+    private val glensPermits = Semaphore(concurrencyFor(OcrRepositoryImpl.EngineType.GLENS))
+    private val owOcrPermits = Semaphore(concurrencyFor(OcrRepositoryImpl.EngineType.OWOCR))
+    private val detectionPermits = Semaphore(DETECTION_CONCURRENCY)
 
     suspend fun <T> withTextEngineLock(
         type: OcrRepositoryImpl.EngineType,
         block: suspend () -> T,
     ): T {
-        return mutexFor(type).withLock {
+        return permitsFor(type).withPermit {
             block()
         }
     }
 
     suspend fun <T> withDetectionLock(block: suspend () -> T): T {
-        return detectionMutex.withLock {
+        return detectionPermits.withPermit {
             block()
         }
     }
 
+    /** Waits until no engine is in use, e.g. before closing them all. */
     suspend fun <T> withAllLocks(block: suspend () -> T): T {
-        return legacyMutex.withLock {
-            fastMutex.withLock {
-                glensMutex.withLock {
-                    owOcrMutex.withLock {
-                        detectionMutex.withLock {
-                            block()
-                        }
-                    }
+        val engines = listOf(
+            legacyPermits to concurrencyFor(OcrRepositoryImpl.EngineType.LEGACY),
+            fastPermits to concurrencyFor(OcrRepositoryImpl.EngineType.FAST),
+            glensPermits to concurrencyFor(OcrRepositoryImpl.EngineType.GLENS),
+            owOcrPermits to concurrencyFor(OcrRepositoryImpl.EngineType.OWOCR),
+            detectionPermits to DETECTION_CONCURRENCY,
+        )
+        val held = ArrayList<Semaphore>()
+        try {
+            engines.forEach { (permits, count) ->
+                repeat(count) {
+                    permits.acquire()
+                    held += permits
                 }
             }
+            return block()
+        } finally {
+            held.forEach { it.release() }
         }
     }
 
-    private fun mutexFor(type: OcrRepositoryImpl.EngineType): Mutex {
+    private fun permitsFor(type: OcrRepositoryImpl.EngineType): Semaphore {
         return when (type) {
-            OcrRepositoryImpl.EngineType.LEGACY -> legacyMutex
-            OcrRepositoryImpl.EngineType.FAST -> fastMutex
-            OcrRepositoryImpl.EngineType.GLENS -> glensMutex
-            OcrRepositoryImpl.EngineType.OWOCR -> owOcrMutex
+            OcrRepositoryImpl.EngineType.LEGACY -> legacyPermits
+            OcrRepositoryImpl.EngineType.FAST -> fastPermits
+            OcrRepositoryImpl.EngineType.GLENS -> glensPermits
+            OcrRepositoryImpl.EngineType.OWOCR -> owOcrPermits
         }
     }
+
+    companion object {
+        const val DETECTION_CONCURRENCY = 1
+
+        // On-device engines own a single LiteRT interpreter; network engines are stateless per request.
+        fun concurrencyFor(type: OcrRepositoryImpl.EngineType): Int {
+            return when (type) {
+                OcrRepositoryImpl.EngineType.LEGACY,
+                OcrRepositoryImpl.EngineType.FAST,
+                -> 1
+                OcrRepositoryImpl.EngineType.GLENS,
+                OcrRepositoryImpl.EngineType.OWOCR,
+                -> NETWORK_CONCURRENCY
+            }
+        }
+
+        private const val NETWORK_CONCURRENCY = 3
+    }
 }
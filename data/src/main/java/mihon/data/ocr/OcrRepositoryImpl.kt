@@ -12,6 +12,7 @@ import kotlinx.coroutines.launch
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import logcat.LogPriority
+import mihon.data.panel.PanelDetectionRepositoryImpl
 import mihon.domain.ocr.exception.OcrException
 import mihon.domain.ocr.model.OcrBoundingBox
 import mihon.domain.ocr.model.OcrImage
@@ -22,6 +23,7 @@ import mihon.domain.ocr.model.OcrTextOrientation
 import mihon.domain.ocr.repository.OcrRepository
 import tachiyomi.core.common.preference.AndroidPreferenceStore
 import tachiyomi.core.common.preference.getEnum
+import tachiyomi.core.common.util.system.ReadingDirection
 import tachiyomi.core.common.util.system.logcat
 import java.net.ConnectException
 import java.net.SocketTimeoutException
@@ -32,6 +34,7 @@ import java.net.UnknownHostException
  */
 class OcrRepositoryImpl(
     private val context: Context,
+    private val panelDetection: PanelDetectionRepositoryImpl,
 ) : OcrRepository {
     private val preferenceStore = AndroidPreferenceStore(context)
     private val ocrModelPref = preferenceStore.getEnum("pref_ocr_model", OcrModel.LEGACY)
@@ -60,12 +63,19 @@ class OcrRepositoryImpl(
     private val sessionMutex = Mutex()
     private val operationMutex = Mutex()
     private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
-    private val taskQueue = PrioritizedTaskQueue(scope) {
+    private val taskQueue = PrioritizedTaskQueue(scope, workerCount = OCR_WORKER_COUNT) {
         scope.launch {
             performDeferredCleanupIfIdle()
         }
     }
 
+    // Queue budgets mirror the engine locks, so a task only takes a worker once its engine is free.
+    private val detectionBudget = PrioritizedTaskQueue.Budget("detection", OcrEngineLocks.DETECTION_CONCURRENCY)
+    private val engineBudgets = EngineType.entries.associateWith { type ->
+        PrioritizedTaskQueue.Budget(type.name.lowercase(), OcrEngineLocks.concurrencyFor(type))
+    }
+    private val engineCreationLock = Any()
+
     private var cleanupRequested = false
 
     private var activeScanSessions = 0
@@ -122,8 +132,8 @@ class OcrRepositoryImpl(
         return environmentResult.isSuccess
     }
 
-    private fun engineFor(type: EngineType): OcrEngine {
-        return when (type) {
+    private fun engineFor(type: EngineType): OcrEngine = synchronized(engineCreationLock) {
+        when (type) {
             EngineType.FAST -> {
                 fastEngine ?: FastOcrEngine(context, requireEnvironment(), textPostprocessor).also {
                     fastEngine = it
@@ -150,7 +160,7 @@ class OcrRepositoryImpl(
     private fun detectionEngine(): DetOcrEngine {
         return detEngine ?: (
             if (localOcrAvailable()) {
-                UnavailableDetOcrEngine() // TODO: replace with real DetOcrEngine with a local model
+                BubbleDetOcrEngine(panelDetection)
             } else {
                 UnavailableDetOcrEngine()
             }
@@ -165,6 +175,12 @@ class OcrRepositoryImpl(
         }
     }
 
+    private suspend fun recognizeBatchWithEngine(type: EngineType, images: List<Bitmap>): List<String> {
+        return engineLocks.withTextEngineLock(type) {
+            engineFor(type).recognizeBatch(images)
+        }
+    }
+
     private suspend fun recognizeWithFallback(primary: EngineType, image: Bitmap): String {
         return try {
             recognizeWithEngine(primary, image)
@@ -196,9 +212,10 @@ class OcrRepositoryImpl(
 
     override suspend fun recognizeText(image: OcrImage): String {
         return withActiveOperation {
-            submitTask(PrioritizedTaskQueue.Priority.HIGH) {
+            val engineType = selectedEngineType()
+            submitTask(PrioritizedTaskQueue.Priority.HIGH, engineBudgets.getValue(engineType)) {
                 image.useBitmap { bitmap ->
-                    recognizeWithFallback(selectedEngineType(), bitmap)
+                    recognizeWithFallback(engineType, bitmap)
                 }
             }
         }
@@ -208,10 +225,19 @@ class OcrRepositoryImpl(
         chapterId: Long,
         pageIndex: Int,
         image: OcrImage,
+        direction: ReadingDirection,
+        persist: Boolean,
     ): OcrPageResult {
         return withActiveOperation {
             val result = image.useBitmap { bitmap ->
-                when (val selectedModel = ocrModelPref.get()) {
+                val selectedModel = ocrModelPref.get()
+                val contentHash = bitmap.contentHash()
+                cacheStore.getPageByContentHash(contentHash, selectedModel)?.let { cached ->
+                    logcat(LogPriority.INFO) { "OCR cache hit by content for chapter=$chapterId page=$pageIndex" }
+                    return@useBitmap cached.copy(chapterId = chapterId, pageIndex = pageIndex)
+                }
+
+                when (selectedModel) {
                     OcrModel.GLENS -> scanWithGlens(
                         chapterId = chapterId,
                         pageIndex = pageIndex,
@@ -224,6 +250,7 @@ class OcrRepositoryImpl(
                         image = bitmap,
                         modelKey = selectedModel,
                         type = EngineType.LEGACY,
+                        direction = direction,
                     )
                     OcrModel.FAST -> scanLocalOrFallback(
                         chapterId = chapterId,
@@ -231,6 +258,7 @@ class OcrRepositoryImpl(
                         image = bitmap,
                         modelKey = selectedModel,
                         type = EngineType.FAST,
+                        direction = direction,
                     )
                     OcrModel.OWOCR -> scanOwOcrOrFallback(
                         chapterId = chapterId,
@@ -238,14 +266,20 @@ class OcrRepositoryImpl(
                         image = bitmap,
                         modelKey = selectedModel,
                     )
-                }
+                }.copy(contentHash = contentHash)
             }
 
-            cacheStore.upsert(result)
+            if (persist) {
+                cacheStore.upsert(result)
+            }
             result
         }
     }
 
+    override suspend fun cachePages(results: List<OcrPageResult>) {
+        cacheStore.upsertAll(results)
+    }
+
     override suspend fun getCachedPage(
         chapterId: Long,
         pageIndex: Int,
@@ -256,12 +290,24 @@ class OcrRepositoryImpl(
         )
     }
 
+    override suspend fun prefetchChapter(chapterId: Long) {
+        cacheStore.prefetchChapter(chapterId)
+    }
+
     override suspend fun getCachedChapterIds(chapterIds: Collection<Long>): Set<Long> {
         return cacheStore.getCachedChapterIds(
             chapterIds = chapterIds,
         )
     }
 
+    override suspend fun startChapterScan(chapterId: Long): Long {
+        return cacheStore.startChapterScan(chapterId)
+    }
+
+    override suspend fun finishChapterScan(chapterId: Long, startedAt: Long) {
+        cacheStore.finishChapterScan(chapterId, startedAt)
+    }
+
     override suspend fun clearCachedChapter(chapterId: Long) {
         cacheStore.clearChapter(chapterId)
     }
@@ -295,6 +341,7 @@ class OcrRepositoryImpl(
         image: Bitmap,
         modelKey: OcrModel,
         type: EngineType,
+        direction: ReadingDirection,
     ): OcrPageResult {
         return try {
             scanLocally(
@@ -303,6 +350,7 @@ class OcrRepositoryImpl(
                 image = image,
                 modelKey = modelKey,
                 type = type,
+                direction = direction,
             )
         } catch (e: OcrException.DetectionUnavailable) {
             if (!useFallbackModelsPref.get()) {
@@ -327,11 +375,9 @@ class OcrRepositoryImpl(
         modelKey: OcrModel,
     ): OcrPageResult {
         val result = try {
-            submitTask(PrioritizedTaskQueue.Priority.NORMAL) {
+            submitTask(PrioritizedTaskQueue.Priority.NORMAL, engineBudgets.getValue(EngineType.GLENS)) {
                 engineLocks.withTextEngineLock(EngineType.GLENS) {
-                    val engine = glensEngine ?: GlensOcrEngine().also {
-                        glensEngine = it
-                    }
+                    val engine = engineFor(EngineType.GLENS) as GlensOcrEngine
                     engine.recognizePage(image)
                 }
             }
@@ -359,11 +405,9 @@ class OcrRepositoryImpl(
         modelKey: OcrModel,
     ): OcrPageResult {
         val result = try {
-            submitTask(PrioritizedTaskQueue.Priority.NORMAL) {
+            submitTask(PrioritizedTaskQueue.Priority.NORMAL, engineBudgets.getValue(EngineType.OWOCR)) {
                 engineLocks.withTextEngineLock(EngineType.OWOCR) {
-                    val engine = owOcrEngine ?: OwOcrEngine(context).also {
-                        owOcrEngine = it
-                    }
+                    val engine = engineFor(EngineType.OWOCR) as OwOcrEngine
                     engine.recognizePage(image)
                 }
             }
@@ -420,34 +464,46 @@ class OcrRepositoryImpl(
         image: Bitmap,
         modelKey: OcrModel,
         type: EngineType,
+        direction: ReadingDirection,
     ): OcrPageResult {
-        val boxes = submitTask(PrioritizedTaskQueue.Priority.NORMAL) {
+        val boxes = submitTask(PrioritizedTaskQueue.Priority.NORMAL, detectionBudget) {
             engineLocks.withDetectionLock {
                 val engine = detectionEngine()
-                engine.detectTextRegions(image)
+                engine.detectTextRegions(image, direction)
             }
         }
             .filter(OcrBoundingBox::isValid)
 
-        val regions = boxes.mapIndexedNotNull { index, box ->
-            val crop = cropBitmap(image, box) ?: return@mapIndexedNotNull null
+        // Crops are recognized in small batches: large enough to amortise engine setup, small
+        // enough that a HIGH priority request for the same engine only waits for one chunk.
+        val regions = boxes.withIndex().chunked(CROP_BATCH_SIZE).flatMap { chunk ->
+            val crops = chunk.mapNotNull { (index, box) ->
+                cropBitmap(image, box)?.let { crop -> IndexedValue(index, crop) }
+            }
+            if (crops.isEmpty()) return@flatMap emptyList()
             try {
-                val text = submitTask(PrioritizedTaskQueue.Priority.NORMAL) {
-                    recognizeWithEngine(type, crop)
-                }.trim()
-                if (text.isBlank()) {
-                    null
-                } else {
-                    OcrRegion(
-                        order = index,
-                        text = text,
-                        boundingBox = box,
-                        textOrientation = OcrTextOrientation.Horizontal,
-                    )
+                val texts = submitTask(PrioritizedTaskQueue.Priority.NORMAL, engineBudgets.getValue(type)) {
+                    recognizeBatchWithEngine(type, crops.map { it.value })
+                }
+                crops.zip(texts).mapNotNull { (crop, rawText) ->
+                    val text = rawText.trim()
+                    if (text.isBlank()) {
+                        null
+                    } else {
+                        OcrRegion(
+                            order = crop.index,
+                            text = text,
+                            boundingBox = boxes[crop.index],
+                            textOrientation = OcrTextOrientation.Horizontal,
+                        )
+                    }
                 }
             } finally {
-                if (!crop.isRecycled) {
-                    crop.recycle()
+                crops.forEach { (_, crop) ->
+                    // createBitmap hands back the page itself when the box covers all of it.
+                    if (crop !== image && !crop.isRecycled) {
+                        crop.recycle()
+                    }
                 }
             }
         }
@@ -490,9 +546,14 @@ class OcrRepositoryImpl(
 
     private suspend fun <T> submitTask(
         priority: PrioritizedTaskQueue.Priority,
+        budget: PrioritizedTaskQueue.Budget,
         block: suspend () -> T,
     ): T {
-        return taskQueue.submit(priority, block)
+        return taskQueue.submit(priority, budget, block)
+    }
+
+    internal suspend fun queueDiagnostics(): PrioritizedTaskQueue.Diagnostics {
+        return taskQueue.diagnostics()
     }
 
     private suspend fun <T> withActiveOperation(block: suspend () -> T): T {
@@ -533,16 +594,29 @@ class OcrRepositoryImpl(
         }
     }
 
+    /**
+     * Runs [block] with an ARGB_8888 bitmap of this image. Bitmap-backed images are shared as-is;
+     * only other configs or pixel-backed images pay for a copy.
+     */
     private suspend fun <T> OcrImage.useBitmap(
         block: suspend (Bitmap) -> T,
     ): T {
-        val bitmap = Bitmap.createBitmap(pixels, width, height, Bitmap.Config.ARGB_8888)
-        return try {
-            block(bitmap)
-        } finally {
-            if (!bitmap.isRecycled) {
-                bitmap.recycle()
+        retain()
+        try {
+            val source = (this as? BitmapOcrImage)?.bitmap
+            val shared = source?.takeIf { it.config == Bitmap.Config.ARGB_8888 }
+            val bitmap = shared
+                ?: source?.copy(Bitmap.Config.ARGB_8888, false)
+                ?: Bitmap.createBitmap(copyPixels(), width, height, Bitmap.Config.ARGB_8888)
+            return try {
+                block(bitmap)
+            } finally {
+                if (bitmap !== shared && !bitmap.isRecycled) {
+                    bitmap.recycle()
+                }
             }
+        } finally {
+            release()
         }
     }
 
@@ -572,4 +646,11 @@ class OcrRepositoryImpl(
             detEngine = null
         }
     }
+
+    private companion object {
+        // Enough for detection, an on-device model and a couple of network requests to overlap.
+        const val OCR_WORKER_COUNT = 4
+
+        const val CROP_BATCH_SIZE = 4
+    }
 }
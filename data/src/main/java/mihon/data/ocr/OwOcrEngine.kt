@@ -2,7 +2,6 @@ package mihon.data.ocr
 
 import android.content.Context
 import android.graphics.Bitmap
-import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.withContext
 import kotlinx.serialization.Serializable
@@ -13,11 +12,6 @@ import mihon.domain.ocr.model.OcrRegion
 import mihon.domain.ocr.model.OcrTextOrientation
 import mihon.domain.ocr.service.OcrPreferences
 import okhttp3.OkHttpClient
-import okhttp3.Request
-import okhttp3.Response
-import okhttp3.WebSocket
-import okhttp3.WebSocketListener
-import okio.ByteString.Companion.toByteString
 import uy.kohesive.injekt.Injekt
 import uy.kohesive.injekt.api.get
 import java.io.ByteArrayOutputStream
@@ -70,72 +64,27 @@ internal class OwOcrEngine(context: Context) : OcrEngine {
         .connectTimeout(15, TimeUnit.SECONDS)
         .readTimeout(60, TimeUnit.SECONDS)
         .writeTimeout(60, TimeUnit.SECONDS)
+        // Keeps the idle session alive and notices a vanished server before the next image.
+        .pingInterval(30, TimeUnit.SECONDS)
         .build()
 
     private val jsonParser = Json { ignoreUnknownKeys = true }
 
-    private suspend fun queryServer(image: Bitmap): String = withContext(Dispatchers.IO) {
-        val address = ocrPreferences.owocrAddress().get().trim()
-        if (address.isBlank()) {
-            throw IOException("OwOCR address is blank. Please configure it in settings.")
-        }
-
-        val stream = ByteArrayOutputStream()
-        val success = image.compress(Bitmap.CompressFormat.PNG, 100, stream)
-        if (!success) {
-            throw IOException("Failed to compress bitmap to PNG")
-        }
-        val imageBytes = stream.toByteArray()
-
-        val request = Request.Builder()
-            .url(address)
-            .build()
-
-        val deferredResult = CompletableDeferred<String>()
-        var webSocket: WebSocket? = null
-
-        val listener = object : WebSocketListener() {
-            private var accepted = false
-
-            override fun onOpen(webSocket: WebSocket, response: Response) {
-                webSocket.send(imageBytes.toByteString())
+    private val session = OwOcrSession(
+        client = client,
+        address = { ocrPreferences.owocrAddress().get() },
+    )
+
+    private suspend fun queryServer(image: Bitmap): String {
+        val imageBytes = withContext(Dispatchers.IO) {
+            val stream = ByteArrayOutputStream()
+            val success = image.compress(Bitmap.CompressFormat.PNG, 100, stream)
+            if (!success) {
+                throw IOException("Failed to compress bitmap to PNG")
             }
-
-            override fun onMessage(webSocket: WebSocket, text: String) {
-                // The first message is typically 'True' or 'False' indicating acceptance
-                if (!accepted) {
-                    if (text == "True") {
-                        accepted = true
-                        // Wait for the actual OCR result
-                    } else {
-                        deferredResult.completeExceptionally(IOException("Server rejected the image with: $text"))
-                        webSocket.close(1000, "Rejected")
-                    }
-                } else {
-                    deferredResult.complete(text)
-                    webSocket.close(1000, "Done")
-                }
-            }
-
-            override fun onFailure(webSocket: WebSocket, t: Throwable, response: Response?) {
-                deferredResult.completeExceptionally(t)
-            }
-
-            override fun onClosing(webSocket: WebSocket, code: Int, reason: String) {
-                if (!deferredResult.isCompleted) {
-                    deferredResult.completeExceptionally(IOException("Connection closed: $reason ($code)"))
-                }
-            }
-        }
-
-        webSocket = client.newWebSocket(request, listener)
-
-        try {
-            deferredResult.await()
-        } catch (t: Throwable) {
-            webSocket.cancel()
-            throw t
+            stream.toByteArray()
         }
+        return session.query(imageBytes)
     }
 
     override suspend fun recognizeText(image: Bitmap): String {
@@ -217,6 +166,6 @@ internal class OwOcrEngine(context: Context) : OcrEngine {
     }
 
     override fun close() {
-        // OkHttpClient resources are automatically pooled and closed, no-op
+        session.close()
     }
 }
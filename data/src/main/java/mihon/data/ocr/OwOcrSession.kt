@@ -0,0 +1,221 @@
+package mihon.data.ocr
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Semaphore
+import logcat.LogPriority
+import okhttp3.OkHttpClient
+import okhttp3.Request
+import okhttp3.Response
+import okhttp3.WebSocket
+import okhttp3.WebSocketListener
+import okio.ByteString
+import okio.ByteString.Companion.toByteString
+import tachiyomi.core.common.util.system.logcat
+import java.io.Closeable
+import java.io.IOException
+import java.io.InterruptedIOException
+
+/**
+ * Long-lived connection to an OwOCR WebSocket server.
+ *
+ * OwOCR answers every image with an acceptance message followed by the result, in the order the
+ * images were received, so up to [maxInFlight] images are pipelined over one socket and acceptances
+ * and results are each matched to requests first-in first-out. A dropped connection is re-established on the next
+ * request after a backoff, and requests it orphaned are resent on the new socket. An image left
+ * unanswered for [requestTimeoutMillis] fails and the socket is replaced.
+ */
+internal class OwOcrSession(
+    private val client: OkHttpClient,
+    private val address: () -> String,
+    maxInFlight: Int = DEFAULT_MAX_IN_FLIGHT,
+    private val requestTimeoutMillis: Long = DEFAULT_REQUEST_TIMEOUT_MILLIS,
+    private val backoffMillis: (failures: Int) -> Long = ::defaultBackoffMillis,
+) : Closeable {
+    private class PendingRequest(val payload: ByteString) {
+        val result = CompletableDeferred<String>()
+        var accepted = false
+    }
+
+    private class ConnectionLostException(message: String, cause: Throwable? = null) : IOException(message, cause)
+
+    private val permits = Semaphore(maxInFlight)
+    private val deadlineScope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+    private val lock = Any()
+
+    // Guarded by [lock].
+    private var socket: WebSocket? = null
+    private var socketAddress: String? = null
+    private val inFlight = ArrayDeque<PendingRequest>()
+    private var consecutiveFailures = 0
+    private var reconnectAtNanos = 0L
+
+    suspend fun query(image: ByteArray): String {
+        val payload = image.toByteString()
+        repeat(MAX_ATTEMPTS - 1) {
+            try {
+                return sendOnce(payload)
+            } catch (e: ConnectionLostException) {
+                logcat(LogPriority.DEBUG, e) { "OwOCR connection lost, resending image" }
+            }
+        }
+        return sendOnce(payload)
+    }
+
+    private suspend fun sendOnce(payload: ByteString): String {
+        awaitReconnectWindow()
+        permits.acquire()
+        val request = PendingRequest(payload)
+        // The permit and the deadline follow the request rather than the caller, so an image whose
+        // caller was cancelled keeps counting against maxInFlight until it is answered or times out.
+        val deadline = deadlineScope.launch {
+            delay(requestTimeoutMillis)
+            onRequestTimedOut(request)
+        }
+        request.result.invokeOnCompletion {
+            deadline.cancel()
+            permits.release()
+        }
+        try {
+            synchronized(lock) { sendLocked(request) }
+        } catch (e: Throwable) {
+            request.result.completeExceptionally(e)
+            throw e
+        }
+        return request.result.await()
+    }
+
+    private suspend fun awaitReconnectWindow() {
+        val waitNanos = synchronized(lock) { reconnectAtNanos - System.nanoTime() }
+        if (waitNanos > 0) {
+            delay(waitNanos / 1_000_000)
+        }
+    }
+
+    private fun sendLocked(request: PendingRequest) {
+        val target = address().trim()
+        if (target.isBlank()) {
+            throw IOException("OwOCR address is blank. Please configure it in settings.")
+        }
+
+        val current = socket?.takeIf { socketAddress == target } ?: run {
+            socket?.let { previous ->
+                dropLocked(previous, "Address changed").forEach {
+                    it.result.completeExceptionally(ConnectionLostException("OwOCR address changed"))
+                }
+            }
+            client.newWebSocket(Request.Builder().url(target).build(), Listener()).also {
+                socket = it
+                socketAddress = target
+            }
+        }
+
+        inFlight.addLast(request)
+        // Messages sent before the handshake completes are queued by OkHttp and flushed on open.
+        if (!current.send(request.payload)) {
+            onConnectionLost(current, ConnectionLostException("OwOCR connection is closing"))
+        }
+    }
+
+    private fun dropLocked(webSocket: WebSocket, reason: String): List<PendingRequest> {
+        webSocket.close(NORMAL_CLOSURE, reason)
+        socket = null
+        socketAddress = null
+        return inFlight.toList().also { inFlight.clear() }
+    }
+
+    private fun onConnectionLost(webSocket: WebSocket, cause: ConnectionLostException) {
+        val orphaned = synchronized(lock) {
+            if (webSocket !== socket) return
+            recycleLocked(webSocket)
+        }
+        orphaned.forEach { it.result.completeExceptionally(cause) }
+    }
+
+    private fun onRequestTimedOut(request: PendingRequest) {
+        val orphaned = synchronized(lock) {
+            if (!inFlight.remove(request)) return
+            // A late answer to the abandoned image would be matched to the next request, so the
+            // socket is replaced and the other images are resent.
+            socket?.let(::recycleLocked).orEmpty()
+        }
+        request.result.completeExceptionally(
+            InterruptedIOException("OwOCR did not answer within $requestTimeoutMillis ms"),
+        )
+        orphaned.forEach { it.result.completeExceptionally(ConnectionLostException("OwOCR request timed out")) }
+    }
+
+    private fun recycleLocked(webSocket: WebSocket): List<PendingRequest> {
+        webSocket.cancel()
+        socket = null
+        socketAddress = null
+        consecutiveFailures++
+        reconnectAtNanos = System.nanoTime() + backoffMillis(consecutiveFailures) * 1_000_000
+        return inFlight.toList().also { inFlight.clear() }
+    }
+
+    private inner class Listener : WebSocketListener() {
+        override fun onMessage(webSocket: WebSocket, text: String) {
+            val (request, completion) = synchronized(lock) {
+                if (webSocket !== socket) return
+                // Acknowledgements and results are each FIFO, but the server may acknowledge
+                // several images before sending the first result, so they're matched separately.
+                val awaitingAck = inFlight.indexOfFirst { !it.accepted }
+                val awaitingResult = inFlight.indexOfFirst { it.accepted }
+                when {
+                    text == ACCEPTED && awaitingAck >= 0 -> {
+                        inFlight[awaitingAck].accepted = true
+                        return
+                    }
+                    text != REJECTED && awaitingResult >= 0 -> {
+                        consecutiveFailures = 0
+                        inFlight.removeAt(awaitingResult) to Result.success(text)
+                    }
+                    awaitingAck >= 0 -> inFlight.removeAt(awaitingAck) to Result.failure<String>(
+                        IOException("Server rejected the image with: $text"),
+                    )
+                    else -> return
+                }
+            }
+            completion
+                .onSuccess { request.result.complete(it) }
+                .onFailure { request.result.completeExceptionally(it) }
+        }
+
+        override fun onClosing(webSocket: WebSocket, code: Int, reason: String) {
+            onConnectionLost(webSocket, ConnectionLostException("Connection closed: $reason ($code)"))
+        }
+
+        override fun onFailure(webSocket: WebSocket, t: Throwable, response: Response?) {
+            onConnectionLost(webSocket, ConnectionLostException("OwOCR connection failed", t))
+        }
+    }
+
+    override fun close() {
+        val orphaned = synchronized(lock) {
+            val current = socket ?: return
+            dropLocked(current, "Closed")
+        }
+        orphaned.forEach { it.result.completeExceptionally(IOException("OwOCR session closed")) }
+    }
+
+    companion object {
+        const val DEFAULT_MAX_IN_FLIGHT = 4
+        const val DEFAULT_REQUEST_TIMEOUT_MILLIS = 60_000L
+
+        private const val MAX_ATTEMPTS = 3
+        private const val ACCEPTED = "True"
+        private const val REJECTED = "False"
+        private const val NORMAL_CLOSURE = 1000
+        private const val INITIAL_BACKOFF_MILLIS = 500L
+        private const val MAX_BACKOFF_MILLIS = 30_000L
+
+        private fun defaultBackoffMillis(failures: Int): Long {
+            return (INITIAL_BACKOFF_MILLIS shl (failures - 1).coerceIn(0, 6)).coerceAtMost(MAX_BACKOFF_MILLIS)
+        }
+    }
+}
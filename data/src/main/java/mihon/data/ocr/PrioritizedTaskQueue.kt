@@ -1,14 +1,24 @@
 package mihon.data.ocr
 
+import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.CoroutineScope
-import kotlinx.coroutines.Job
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 
+/**
+ * Runs OCR tasks on up to [workerCount] workers.
+ *
+ * [Priority.HIGH] tasks are always picked before [Priority.NORMAL] ones, and with more than one
+ * worker a slot is kept free of NORMAL work so interactive requests never wait behind a full batch.
+ * Tasks may name a [Budget] that caps how many tasks sharing it run at once; a task whose budget is
+ * exhausted is skipped in favour of later runnable tasks instead of blocking its worker.
+ */
 internal class PrioritizedTaskQueue(
     private val scope: CoroutineScope,
+    private val workerCount: Int = 1,
+    private val nanoTime: () -> Long = System::nanoTime,
     private val onIdle: () -> Unit = {},
 ) {
     enum class Priority {
@@ -16,20 +26,57 @@ internal class PrioritizedTaskQueue(
         NORMAL,
     }
 
+    /** Caps how many tasks sharing this budget may run at once, e.g. one per on-device model. */
+    class Budget(val name: String, val limit: Int) {
+        init {
+            require(limit > 0) { "Budget limit must be positive" }
+        }
+    }
+
+    data class Diagnostics(
+        val queuedHigh: Int,
+        val queuedNormal: Int,
+        val running: Int,
+        val oldestQueuedWaitMillis: Long,
+        val averageHighWaitMillis: Long,
+        val averageNormalWaitMillis: Long,
+    )
+
+    private class Task(
+        val priority: Priority,
+        val budget: Budget?,
+        val enqueuedAt: Long,
+        val run: suspend () -> Unit,
+    )
+
     private val mutex = Mutex()
-    private val highPriorityTasks = ArrayDeque<suspend () -> Unit>()
-    private val normalPriorityTasks = ArrayDeque<suspend () -> Unit>()
+    private val highPriorityTasks = ArrayDeque<Task>()
+    private val normalPriorityTasks = ArrayDeque<Task>()
+    private val budgetsInUse = HashMap<Budget, Int>()
 
     private var activeTasks = 0
-    private var workerJob: Job? = null
+    private var activeNormalTasks = 0
+
+    private var startedHighTasks = 0L
+    private var totalHighWaitNanos = 0L
+    private var startedNormalTasks = 0L
+    private var totalNormalWaitNanos = 0L
+
+    // NORMAL work may use every worker but one, so a HIGH task always finds a free slot.
+    private val normalWorkerLimit = (workerCount - 1).coerceAtLeast(1)
+
+    init {
+        require(workerCount > 0) { "Worker count must be positive" }
+    }
 
     suspend fun <T> submit(
         priority: Priority,
+        budget: Budget? = null,
         block: suspend () -> T,
     ): T {
         val result = CompletableDeferred<T>()
 
-        val task: suspend () -> Unit = {
+        val task = Task(priority, budget, nanoTime()) {
             if (!result.isCancelled) {
                 try {
                     result.complete(block())
@@ -44,12 +91,16 @@ internal class PrioritizedTaskQueue(
                 Priority.HIGH -> highPriorityTasks.addLast(task)
                 Priority.NORMAL -> normalPriorityTasks.addLast(task)
             }
-            if (workerJob?.isActive != true) {
-                workerJob = scope.launch { processQueue() }
-            }
+            dispatchLocked()
         }
 
-        return result.await()
+        return try {
+            result.await()
+        } catch (e: CancellationException) {
+            // Lets a still-queued task be skipped instead of running for a caller that left.
+            result.cancel()
+            throw e
+        }
     }
 
     suspend fun isIdle(): Boolean {
@@ -58,32 +109,100 @@ internal class PrioritizedTaskQueue(
         }
     }
 
-    private suspend fun processQueue() {
-        while (true) {
-            val task = mutex.withLock {
-                val nextTask = highPriorityTasks.removeFirstOrNull()
-                    ?: normalPriorityTasks.removeFirstOrNull()
-
-                if (nextTask == null) {
-                    workerJob = null
-                    null
-                } else {
-                    activeTasks++
-                    nextTask
-                }
-            } ?: break
+    suspend fun diagnostics(): Diagnostics {
+        return mutex.withLock {
+            val now = nanoTime()
+            val oldest = listOfNotNull(highPriorityTasks.firstOrNull(), normalPriorityTasks.firstOrNull())
+                .minOfOrNull { it.enqueuedAt }
+            Diagnostics(
+                queuedHigh = highPriorityTasks.size,
+                queuedNormal = normalPriorityTasks.size,
+                running = activeTasks,
+                oldestQueuedWaitMillis = oldest?.let { (now - it) / NANOS_PER_MILLI } ?: 0L,
+                averageHighWaitMillis = averageMillis(totalHighWaitNanos, startedHighTasks),
+                averageNormalWaitMillis = averageMillis(totalNormalWaitNanos, startedNormalTasks),
+            )
+        }
+    }
+
+    /** Starts a worker for every runnable task while worker slots are free. Caller holds [mutex]. */
+    private fun dispatchLocked() {
+        while (activeTasks < workerCount) {
+            val task = takeRunnableLocked() ?: return
+            scope.launch { runWorker(task) }
+        }
+    }
 
+    private fun takeRunnableLocked(): Task? {
+        val task = takeFirstRunnable(highPriorityTasks)
+            ?: takeFirstRunnable(normalPriorityTasks)
+            ?: return null
+
+        activeTasks++
+        if (task.priority == Priority.NORMAL) activeNormalTasks++
+        task.budget?.let { budgetsInUse[it] = (budgetsInUse[it] ?: 0) + 1 }
+
+        val waitNanos = nanoTime() - task.enqueuedAt
+        when (task.priority) {
+            Priority.HIGH -> {
+                startedHighTasks++
+                totalHighWaitNanos += waitNanos
+            }
+            Priority.NORMAL -> {
+                startedNormalTasks++
+                totalNormalWaitNanos += waitNanos
+            }
+        }
+        return task
+    }
+
+    private fun takeFirstRunnable(tasks: ArrayDeque<Task>): Task? {
+        if (tasks.isEmpty()) return null
+        if (tasks === normalPriorityTasks && activeNormalTasks >= normalWorkerLimit) return null
+
+        val index = tasks.indexOfFirst { task ->
+            val budget = task.budget ?: return@indexOfFirst true
+            (budgetsInUse[budget] ?: 0) < budget.limit
+        }
+        return if (index >= 0) tasks.removeAt(index) else null
+    }
+
+    private suspend fun runWorker(firstTask: Task) {
+        var task: Task? = firstTask
+        while (task != null) {
+            val current: Task = task
             try {
-                task()
+                current.run()
             } finally {
-                val becameIdle = mutex.withLock {
-                    activeTasks--
-                    activeTasks == 0 && highPriorityTasks.isEmpty() && normalPriorityTasks.isEmpty()
+                val (next, becameIdle) = mutex.withLock {
+                    finishLocked(current)
+                    val next = takeRunnableLocked()
+                    // The finished task may have freed a budget that unblocks more than one task.
+                    dispatchLocked()
+                    next to (activeTasks == 0 && highPriorityTasks.isEmpty() && normalPriorityTasks.isEmpty())
                 }
+                task = next
                 if (becameIdle) {
                     onIdle()
                 }
             }
         }
     }
+
+    private fun finishLocked(task: Task) {
+        activeTasks--
+        if (task.priority == Priority.NORMAL) activeNormalTasks--
+        task.budget?.let { budget ->
+            val remaining = (budgetsInUse[budget] ?: 1) - 1
+            if (remaining == 0) budgetsInUse.remove(budget) else budgetsInUse[budget] = remaining
+        }
+    }
+
+    private fun averageMillis(totalNanos: Long, count: Long): Long {
+        return if (count == 0L) 0L else totalNanos / count / NANOS_PER_MILLI
+    }
+
+    private companion object {
+        const val NANOS_PER_MILLI = 1_000_000L
+    }
 }
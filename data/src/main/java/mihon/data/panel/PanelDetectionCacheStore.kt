@@ -0,0 +1,150 @@
+package mihon.data.panel
+
+import android.content.Context
+import android.graphics.Rect
+import app.cash.sqldelight.driver.android.AndroidSqliteDriver
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import kotlinx.serialization.Serializable
+import kotlinx.serialization.SerializationException
+import kotlinx.serialization.json.Json
+import logcat.LogPriority
+import mihon.domain.panel.model.DebugPanelDetection
+import mihon.domain.panel.model.PanelDetectionResult
+import tachiyomi.core.common.util.system.Panel
+import tachiyomi.core.common.util.system.ReadingDirection
+import tachiyomi.core.common.util.system.logcat
+import tachiyomi.data.panel.PanelCacheDatabase
+
+/**
+ * On-disk cache of panel detections, keyed by page content and reading direction.
+ *
+ * Rows are tagged with the detector model they came from; rows of any other model are never
+ * returned and are purged when the database is opened, together with the oldest rows past
+ * [MAX_ENTRIES].
+ */
+internal class PanelDetectionCacheStore(
+    private val context: Context,
+) {
+    private val mutex = Mutex()
+
+    private var database: PanelCacheDatabase? = null
+
+    suspend fun get(
+        key: Key,
+        modelVersion: String,
+    ): PanelDetectionResult? {
+        val json = mutex.withLock {
+            getDatabase(modelVersion).panel_cacheQueries.getDetection(
+                contentHash = key.contentHash,
+                readingDirection = key.direction.name,
+                originalWidth = key.originalWidth.toLong(),
+                originalHeight = key.originalHeight.toLong(),
+                modelVersion = modelVersion,
+            ).executeAsOneOrNull()
+        } ?: return null
+
+        return try {
+            json.decode().toResult()
+        } catch (e: SerializationException) {
+            logcat(LogPriority.WARN, e) { "Discarding unreadable panel cache entry ${key.contentHash}" }
+            null
+        } catch (e: IllegalArgumentException) {
+            logcat(LogPriority.WARN, e) { "Discarding unreadable panel cache entry ${key.contentHash}" }
+            null
+        }
+    }
+
+    suspend fun put(
+        key: Key,
+        modelVersion: String,
+        result: PanelDetectionResult,
+    ) {
+        val json = JSON.encodeToString(StoredResult.serializer(), StoredResult.from(result))
+        mutex.withLock {
+            getDatabase(modelVersion).panel_cacheQueries.insertDetection(
+                contentHash = key.contentHash,
+                readingDirection = key.direction.name,
+                originalWidth = key.originalWidth.toLong(),
+                originalHeight = key.originalHeight.toLong(),
+                modelVersion = modelVersion,
+                result = json,
+                createdAt = System.currentTimeMillis(),
+            )
+        }
+    }
+
+    /** Caller holds [mutex]. */
+    private fun getDatabase(modelVersion: String): PanelCacheDatabase {
+        database?.let { return it }
+
+        val driver = AndroidSqliteDriver(
+            schema = PanelCacheDatabase.Schema,
+            context = context,
+            name = DB_NAME,
+        )
+        val database = PanelCacheDatabase(driver)
+        database.transaction {
+            database.panel_cacheQueries.deleteOtherModelVersions(modelVersion)
+            database.panel_cacheQueries.deleteOldest(MAX_ENTRIES)
+        }
+        this.database = database
+        return database
+    }
+
+    private fun String.decode(): StoredResult = JSON.decodeFromString(StoredResult.serializer(), this)
+
+    data class Key(
+        val contentHash: String,
+        val direction: ReadingDirection,
+        val originalWidth: Int,
+        val originalHeight: Int,
+    )
+
+    @Serializable
+    private data class StoredRect(val left: Int, val top: Int, val right: Int, val bottom: Int) {
+        fun toRect() = Rect(left, top, right, bottom)
+
+        companion object {
+            fun from(rect: Rect) = StoredRect(rect.left, rect.top, rect.right, rect.bottom)
+        }
+    }
+
+    @Serializable
+    private data class StoredDetection(val rect: StoredRect, val confidence: Float) {
+        fun toDetection() = DebugPanelDetection(rect.toRect(), confidence)
+
+        companion object {
+            fun from(detection: DebugPanelDetection) =
+                StoredDetection(StoredRect.from(detection.rect), detection.confidence)
+        }
+    }
+
+    @Serializable
+    private data class StoredResult(
+        val panels: List<StoredRect>,
+        val debugPanels: List<StoredDetection> = emptyList(),
+        val debugBubbles: List<StoredDetection> = emptyList(),
+    ) {
+        fun toResult() = PanelDetectionResult(
+            panels = panels.map { Panel(it.toRect()) },
+            debugPanels = debugPanels.map(StoredDetection::toDetection),
+            debugBubbles = debugBubbles.map(StoredDetection::toDetection),
+        )
+
+        companion object {
+            fun from(result: PanelDetectionResult) = StoredResult(
+                panels = result.panels.map { StoredRect.from(it.rect) },
+                debugPanels = result.debugPanels.map(StoredDetection::from),
+                debugBubbles = result.debugBubbles.map(StoredDetection::from),
+            )
+        }
+    }
+
+    companion object {
+        private const val DB_NAME = "panel_cache.db"
+        private const val MAX_ENTRIES = 5_000L
+
+        private val JSON = Json { ignoreUnknownKeys = true }
+    }
+}
@@ -15,6 +15,8 @@ import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
 import logcat.LogPriority
+import mihon.data.ocr.contentHash
+import mihon.domain.ocr.exception.OcrException
 import mihon.domain.panel.model.DebugPanelDetection
 import mihon.domain.panel.model.PanelDetectionResult
 import mihon.domain.panel.repository.PanelDetectionRepository
@@ -23,6 +25,7 @@ import tachiyomi.core.common.util.system.ReadingDirection
 import tachiyomi.core.common.util.system.ReadingOrderSorter
 import tachiyomi.core.common.util.system.logcat
 import java.io.Closeable
+import java.security.MessageDigest
 import kotlin.math.abs
 import kotlin.math.max
 import kotlin.math.roundToInt
@@ -34,6 +37,19 @@ class PanelDetectionRepositoryImpl(
 
     private val environment by lazy { Environment.create() }
 
+    private val cacheStore = PanelDetectionCacheStore(context)
+
+    // Persisted results are only valid for the model and post-processing that produced them.
+    private val modelVersion by lazy { "$POSTPROCESS_VERSION:${hashModelAsset()}" }
+
+    // Kept outside the engine so persistent-cache hits seed it without loading the model.
+    private val memoryCache = object : LinkedHashMap<String, PanelDetectionResult>(CACHE_CAPACITY, 0.75f, true) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<String, PanelDetectionResult>?): Boolean {
+            return size > CACHE_CAPACITY
+        }
+    }
+
+    @Volatile
     private var engine: YoloPanelDetectionEngine? = null
     private val engineMutex = Mutex()
 
@@ -53,13 +69,32 @@ class PanelDetectionRepositoryImpl(
         direction: ReadingDirection,
     ): PanelDetectionResult {
         return try {
+            val memoryKey = "$cacheKey:${direction.name}"
+            synchronized(memoryCache) { memoryCache[memoryKey] }?.let { return it.copy(cacheHit = true) }
+
+            // Checked before the engine is created, so revisits after process death skip model loading too.
+            val storeKey = PanelDetectionCacheStore.Key(
+                contentHash = image.contentHash(),
+                direction = direction,
+                originalWidth = originalWidth,
+                originalHeight = originalHeight,
+            )
+            cacheStore.get(storeKey, modelVersion)?.let { stored ->
+                logcat(LogPriority.VERBOSE) { "Panel detector persistent cache hit key=$cacheKey" }
+                synchronized(memoryCache) { memoryCache[memoryKey] = stored }
+                return stored.copy(cacheHit = true)
+            }
+
             getEngine().detectPanels(
                 cacheKey = cacheKey,
                 image = image,
                 originalWidth = originalWidth,
                 originalHeight = originalHeight,
                 direction = direction,
-            )
+            ).also { result ->
+                synchronized(memoryCache) { memoryCache[memoryKey] = result }
+                cacheStore.put(storeKey, modelVersion, result)
+            }
         } catch (e: CancellationException) {
             throw e
         } catch (e: Throwable) {
@@ -68,15 +103,53 @@ class PanelDetectionRepositoryImpl(
         }
     }
 
+    /**
+     * Runs the panel model on [image] and returns its speech bubbles in page coordinates, sharing
+     * the engine (and its loaded model) with panel detection. Throws
+     * [OcrException.DetectionUnavailable] when the model can't be loaded; other failures are
+     * thrown as they are.
+     */
+    internal suspend fun detectBubbles(image: Bitmap): List<Rect> {
+        val engine = try {
+            getEngine()
+        } catch (e: CancellationException) {
+            throw e
+        } catch (e: Throwable) {
+            logcat(LogPriority.ERROR, e) { "Failed to load the panel detector for OCR" }
+            throw OcrException.DetectionUnavailable(e)
+        }
+        return engine.detectBubbles(image)
+    }
+
     override fun cleanup() {
         try {
             engine?.close()
             engine = null
+            synchronized(memoryCache) { memoryCache.clear() }
             logcat(LogPriority.INFO) { "PanelDetectionRepositoryImpl cleaned up successfully" }
         } catch (e: Exception) {
             logcat(LogPriority.ERROR, e) { "Error cleaning up panel detector" }
         }
     }
+
+    private fun hashModelAsset(): String {
+        val digest = MessageDigest.getInstance("SHA-1")
+        context.assets.open(YoloPanelDetectionEngine.MODEL_PATH).use { input ->
+            val buffer = ByteArray(64 * 1024)
+            while (true) {
+                val read = input.read(buffer)
+                if (read < 0) break
+                digest.update(buffer, 0, read)
+            }
+        }
+        return digest.digest().joinToString(separator = "") { "%02x".format(it) }
+    }
+
+    private companion object {
+        // Bump when changes to result building would alter detections from the same model output.
+        const val POSTPROCESS_VERSION = 1
+        const val CACHE_CAPACITY = 128
+    }
 }
 
 private class YoloPanelDetectionEngine(
@@ -99,13 +172,6 @@ private class YoloPanelDetectionEngine(
     private val pixelBuffer = IntArray(INPUT_SIZE * INPUT_SIZE)
     private val inputFloatBuffer = FloatArray(INPUT_SIZE * INPUT_SIZE * 3)
 
-    private val cache = object : LinkedHashMap<String, PanelDetectionResult>(CACHE_CAPACITY, 0.75f, true) {
-        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<String, PanelDetectionResult>?): Boolean {
-            return size > CACHE_CAPACITY
-        }
-    }
-    private val cacheMutex = Mutex()
-
     init {
         val cpuThreads = Runtime.getRuntime().availableProcessors().coerceIn(2, 4)
         val options = CompiledModel.Options(Accelerator.CPU).apply {
@@ -135,57 +201,69 @@ private class YoloPanelDetectionEngine(
         originalHeight: Int,
         direction: ReadingDirection,
     ): PanelDetectionResult {
-        cacheMutex.withLock {
-            cache[cacheEntryKey(cacheKey, direction)]?.let {
-                return it.copy(cacheHit = true)
-            }
-        }
+        val totalStart = System.nanoTime()
+        val output = runModel(
+            image = image,
+            originalWidth = originalWidth,
+            originalHeight = originalHeight,
+        )
+        val totalNanos = System.nanoTime() - totalStart
 
-        var preprocessNanos = 0L
-        var inferenceNanos = 0L
-        val detections = mutableListOf<ScoredDetection>()
+        return buildResult(
+            cacheKey = cacheKey,
+            originalWidth = originalWidth,
+            originalHeight = originalHeight,
+            direction = direction,
+            preprocessNanos = output.preprocessNanos,
+            inferenceNanos = output.inferenceNanos,
+            totalNanos = totalNanos,
+            detections = output.detections,
+        )
+    }
 
-        val totalStart = System.nanoTime()
-        inferenceMutex.withLock {
-            val preprocessing = preprocessImage(
-                image = image,
-                originalWidth = originalWidth,
-                originalHeight = originalHeight,
-            )
-            preprocessNanos = preprocessing.durationNanos
+    /** Speech bubbles of [image] in its own pixel coordinates, with duplicates removed. */
+    suspend fun detectBubbles(image: Bitmap): List<Rect> {
+        val output = runModel(
+            image = image,
+            originalWidth = image.width,
+            originalHeight = image.height,
+        )
+        return removeHeavyOverlaps(
+            output.detections.filter {
+                it.classId == BUBBLE_CLASS_ID && it.confidence >= BUBBLE_CONFIDENCE_THRESHOLD
+            },
+        ).map { it.rect }
+    }
 
-            inputBuffers[0].writeFloat(inputFloatBuffer)
+    private suspend fun runModel(
+        image: Bitmap,
+        originalWidth: Int,
+        originalHeight: Int,
+    ): ModelOutput = inferenceMutex.withLock {
+        val preprocessing = preprocessImage(
+            image = image,
+            originalWidth = originalWidth,
+            originalHeight = originalHeight,
+        )
 
-            inferenceNanos = measureNanoTime {
-                compiledModel.run(inputBuffers, outputBuffers)
-            }
+        inputBuffers[0].writeFloat(inputFloatBuffer)
 
-            val rawOutputs = outputBuffers.map { it.readFloat() }
+        val inferenceNanos = measureNanoTime {
+            compiledModel.run(inputBuffers, outputBuffers)
+        }
+
+        val rawOutputs = outputBuffers.map { it.readFloat() }
 
-            detections += parseDetections(
+        ModelOutput(
+            detections = parseDetections(
                 rawOutputs = rawOutputs,
                 mapping = preprocessing.mapping,
                 originalWidth = originalWidth,
                 originalHeight = originalHeight,
-            )
-        }
-        val totalNanos = System.nanoTime() - totalStart
-
-        val result = buildResult(
-            cacheKey = cacheKey,
-            originalWidth = originalWidth,
-            originalHeight = originalHeight,
-            direction = direction,
-            preprocessNanos = preprocessNanos,
+            ),
+            preprocessNanos = preprocessing.durationNanos,
             inferenceNanos = inferenceNanos,
-            totalNanos = totalNanos,
-            detections = detections,
         )
-
-        cacheMutex.withLock {
-            cache[cacheEntryKey(cacheKey, direction)] = result
-        }
-        return result
     }
 
     private fun buildResult(
@@ -692,19 +770,11 @@ private class YoloPanelDetectionEngine(
         return if (union == 0) 0f else intersectionArea.toFloat() / union.toFloat()
     }
 
-    private fun cacheEntryKey(
-        cacheKey: String,
-        direction: ReadingDirection,
-    ): String {
-        return "$cacheKey:${direction.name}"
-    }
-
     override fun close() {
         scratchBitmap.recycle()
         inputBuffers.forEach { it.close() }
         outputBuffers.forEach { it.close() }
         compiledModel.close()
-        cache.clear()
     }
 
     private data class PreprocessResult(
@@ -724,6 +794,12 @@ private class YoloPanelDetectionEngine(
         val padY: Float,
     )
 
+    private data class ModelOutput(
+        val detections: List<ScoredDetection>,
+        val preprocessNanos: Long,
+        val inferenceNanos: Long,
+    )
+
     private data class ScoredDetection(
         val rect: Rect,
         val confidence: Float,
@@ -743,7 +819,7 @@ private class YoloPanelDetectionEngine(
     }
 
     companion object {
-        private const val MODEL_PATH = "panel_detector/model.tflite"
+        const val MODEL_PATH = "panel_detector/model.tflite"
         private const val INPUT_SIZE = 640
         private const val DETECTION_STRIDE = 6
         private const val PREFERRED_OUTPUT_COUNT = 300
@@ -761,7 +837,6 @@ private class YoloPanelDetectionEngine(
         private const val MAX_DUPLICATE_IOU = 0.8f
         private const val CONTENT_THRESHOLD = 16
         private const val MIN_CONTENT_SPAN_RATIO = 0.25f
-        private const val CACHE_CAPACITY = 128
         private const val DEBUG_OVERLAY_LIMIT = 10
     }
 }
@@ -0,0 +1,30 @@
+package mihon.data.ocr
+
+import org.junit.jupiter.api.Assertions.assertFalse
+import org.junit.jupiter.api.Assertions.assertTrue
+import org.junit.jupiter.api.Test
+
+class GlensImageEncodingTest {
+
+    @Test
+    fun blackAndWhiteLineArtIsFlat() {
+        val pixels = IntArray(1000) { if (it % 7 == 0) BLACK else WHITE }
+        pixels[0] = gray(128)
+
+        assertTrue(GlensImageEncoding.isFlatArtwork(pixels))
+    }
+
+    @Test
+    fun screentoneOrScannedPageIsNotFlat() {
+        val pixels = IntArray(1000) { gray(60 + it % 140) }
+
+        assertFalse(GlensImageEncoding.isFlatArtwork(pixels))
+    }
+
+    private fun gray(level: Int): Int = (0xFF shl 24) or (level shl 16) or (level shl 8) or level
+
+    private companion object {
+        const val BLACK = 0xFF000000.toInt()
+        const val WHITE = 0xFFFFFFFF.toInt()
+    }
+}
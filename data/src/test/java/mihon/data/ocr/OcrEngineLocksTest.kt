@@ -48,7 +48,7 @@ class OcrEngineLocksTest {
         val secondEntered = CompletableDeferred<Unit>()
 
         val first = async {
-            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.GLENS) {
+            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.FAST) {
                 started.complete(Unit)
                 release.await()
             }
@@ -57,7 +57,7 @@ class OcrEngineLocksTest {
         started.await()
 
         val second = async {
-            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.GLENS) {
+            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.FAST) {
                 secondEntered.complete(Unit)
             }
         }
@@ -71,6 +71,35 @@ class OcrEngineLocksTest {
         assertTrue(secondEntered.isCompleted)
     }
 
+    @Test
+    fun networkEngineAllowsConcurrentRequests() = runTest {
+        val locks = OcrEngineLocks()
+        val started = CompletableDeferred<Unit>()
+        val release = CompletableDeferred<Unit>()
+        val secondEntered = CompletableDeferred<Unit>()
+
+        val first = async {
+            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.GLENS) {
+                started.complete(Unit)
+                release.await()
+            }
+        }
+
+        started.await()
+
+        val second = async {
+            locks.withTextEngineLock(OcrRepositoryImpl.EngineType.GLENS) {
+                secondEntered.complete(Unit)
+            }
+        }
+
+        secondEntered.await()
+        assertTrue(second.isCompleted)
+
+        release.complete(Unit)
+        awaitAll(first, second)
+    }
+
     @Test
     fun withAllLocksWaitsForBusyEngineLocks() = runTest {
         val locks = OcrEngineLocks()
@@ -0,0 +1,155 @@
+package mihon.data.ocr
+
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.test.runTest
+import okhttp3.OkHttpClient
+import okhttp3.WebSocket
+import okhttp3.WebSocketListener
+import okhttp3.mockwebserver.MockResponse
+import okhttp3.mockwebserver.MockWebServer
+import okio.ByteString
+import org.junit.jupiter.api.AfterEach
+import org.junit.jupiter.api.Assertions.assertEquals
+import org.junit.jupiter.api.Assertions.assertThrows
+import org.junit.jupiter.api.BeforeEach
+import org.junit.jupiter.api.Test
+import java.io.IOException
+import java.io.InterruptedIOException
+
+class OwOcrSessionTest {
+
+    private lateinit var server: MockWebServer
+    private lateinit var session: OwOcrSession
+
+    @BeforeEach
+    fun setUp() {
+        server = MockWebServer()
+        server.start()
+        session = OwOcrSession(
+            client = OkHttpClient(),
+            address = { server.url("/").toString().replaceFirst("http", "ws") },
+            backoffMillis = { 0L },
+        )
+    }
+
+    @AfterEach
+    fun tearDown() {
+        session.close()
+        server.shutdown()
+    }
+
+    @Test
+    fun pipelinedImagesShareOneConnection() = runTest {
+        server.enqueue(MockResponse().withWebSocketUpgrade(EchoServer()))
+
+        val results = List(6) { index ->
+            async { session.query("image-$index".toByteArray()) }
+        }.awaitAll()
+
+        assertEquals(List(6) { "echo:image-$it" }, results)
+        assertEquals(1, server.requestCount)
+    }
+
+    @Test
+    fun resultsSentAfterAllAcknowledgementsReachTheirImages() = runTest {
+        server.enqueue(MockResponse().withWebSocketUpgrade(AckFirstServer(batchSize = 3)))
+
+        val results = List(3) { index ->
+            async { session.query("image-$index".toByteArray()) }
+        }.awaitAll()
+
+        assertEquals(List(3) { "echo:image-$it" }, results)
+    }
+
+    @Test
+    fun droppedConnectionIsReopenedAndImageResent() = runTest {
+        server.enqueue(
+            MockResponse().withWebSocketUpgrade(
+                object : WebSocketListener() {
+                    override fun onMessage(webSocket: WebSocket, bytes: ByteString) {
+                        webSocket.close(1001, "Restarting")
+                    }
+                },
+            ),
+        )
+        server.enqueue(MockResponse().withWebSocketUpgrade(EchoServer()))
+
+        val result = session.query("page".toByteArray())
+
+        assertEquals("echo:page", result)
+        assertEquals(2, server.requestCount)
+    }
+
+    @Test
+    fun rejectedImageFailsWithoutRetry() = runTest {
+        server.enqueue(
+            MockResponse().withWebSocketUpgrade(
+                object : WebSocketListener() {
+                    override fun onMessage(webSocket: WebSocket, bytes: ByteString) {
+                        webSocket.send("False")
+                    }
+                },
+            ),
+        )
+
+        val result = runCatching { session.query("page".toByteArray()) }
+
+        assertThrows(IOException::class.java) { result.getOrThrow() }
+        assertEquals(1, server.requestCount)
+    }
+
+    @Test
+    fun unansweredImageTimesOutAndNextImageUsesNewConnection() = runTest {
+        server.enqueue(
+            MockResponse().withWebSocketUpgrade(
+                object : WebSocketListener() {
+                    override fun onMessage(webSocket: WebSocket, bytes: ByteString) {
+                        webSocket.send("True")
+                    }
+                },
+            ),
+        )
+        server.enqueue(MockResponse().withWebSocketUpgrade(EchoServer()))
+        val timingOutSession = OwOcrSession(
+            client = OkHttpClient(),
+            address = { server.url("/").toString().replaceFirst("http", "ws") },
+            maxInFlight = 1,
+            requestTimeoutMillis = 200L,
+            backoffMillis = { 0L },
+        )
+
+        try {
+            val timedOut = runCatching { timingOutSession.query("stuck".toByteArray()) }
+            val result = timingOutSession.query("page".toByteArray())
+
+            assertThrows(InterruptedIOException::class.java) { timedOut.getOrThrow() }
+            assertEquals("echo:page", result)
+            assertEquals(2, server.requestCount)
+        } finally {
+            timingOutSession.close()
+        }
+    }
+
+    /** Acknowledges every image on arrival and only answers once [batchSize] images were received. */
+    private class AckFirstServer(private val batchSize: Int) : WebSocketListener() {
+        private val received = mutableListOf<String>()
+
+        override fun onMessage(webSocket: WebSocket, bytes: ByteString) {
+            webSocket.send("True")
+            val batch = synchronized(received) {
+                received += bytes.utf8()
+                if (received.size < batchSize) return
+                received.toList().also { received.clear() }
+            }
+            batch.forEach { webSocket.send("echo:$it") }
+        }
+    }
+
+    private class EchoServer : WebSocketListener() {
+        override fun onMessage(webSocket: WebSocket, bytes: ByteString) {
+            webSocket.send("True")
+            webSocket.send("echo:${bytes.utf8()}")
+        }
+    }
+}
@@ -6,6 +6,7 @@ import kotlinx.coroutines.async
 import kotlinx.coroutines.test.advanceUntilIdle
 import kotlinx.coroutines.test.runTest
 import org.junit.jupiter.api.Assertions.assertEquals
+import org.junit.jupiter.api.Assertions.assertFalse
 import org.junit.jupiter.api.Assertions.assertTrue
 import org.junit.jupiter.api.Test
 
@@ -84,4 +85,103 @@ class PrioritizedTaskQueueTest {
 
         assertTrue(events.indexOf("recognize-text") < events.indexOf("region-2"))
     }
+
+    @OptIn(ExperimentalCoroutinesApi::class)
+    @Test
+    fun exhaustedBudgetDoesNotBlockOtherEngines() = runTest {
+        val events = mutableListOf<String>()
+        val holdFast = CompletableDeferred<Unit>()
+        val queue = PrioritizedTaskQueue(backgroundScope, workerCount = 3)
+        val fast = PrioritizedTaskQueue.Budget("fast", 1)
+        val glens = PrioritizedTaskQueue.Budget("glens", 2)
+
+        val firstFast = async {
+            queue.submit(PrioritizedTaskQueue.Priority.NORMAL, fast) {
+                events += "fast-1-start"
+                holdFast.await()
+                events += "fast-1-end"
+            }
+        }
+        advanceUntilIdle()
+
+        val secondFast = async {
+            queue.submit(PrioritizedTaskQueue.Priority.NORMAL, fast) {
+                events += "fast-2"
+            }
+        }
+        val network = async {
+            queue.submit(PrioritizedTaskQueue.Priority.NORMAL, glens) {
+                events += "glens"
+            }
+        }
+        advanceUntilIdle()
+
+        assertTrue(network.isCompleted)
+        assertFalse(secondFast.isCompleted)
+
+        holdFast.complete(Unit)
+        firstFast.await()
+        secondFast.await()
+
+        assertEquals(listOf("fast-1-start", "glens", "fast-1-end", "fast-2"), events)
+    }
+
+    @OptIn(ExperimentalCoroutinesApi::class)
+    @Test
+    fun highPriorityTaskGetsReservedWorker() = runTest {
+        val holdNormal = CompletableDeferred<Unit>()
+        val queue = PrioritizedTaskQueue(backgroundScope, workerCount = 2)
+
+        val normal = List(2) {
+            async {
+                queue.submit(PrioritizedTaskQueue.Priority.NORMAL) {
+                    holdNormal.await()
+                }
+            }
+        }
+        advanceUntilIdle()
+
+        val high = async {
+            queue.submit(PrioritizedTaskQueue.Priority.HIGH) { "high" }
+        }
+        advanceUntilIdle()
+
+        assertEquals("high", high.await())
+        assertEquals(1, queue.diagnostics().queuedNormal)
+
+        holdNormal.complete(Unit)
+        normal.forEach { it.await() }
+        assertTrue(queue.isIdle())
+    }
+
+    @OptIn(ExperimentalCoroutinesApi::class)
+    @Test
+    fun diagnosticsReportQueueDepthAndWaitTimes() = runTest {
+        var now = 0L
+        val hold = CompletableDeferred<Unit>()
+        val queue = PrioritizedTaskQueue(backgroundScope, nanoTime = { now })
+
+        val running = async {
+            queue.submit(PrioritizedTaskQueue.Priority.NORMAL) { hold.await() }
+        }
+        advanceUntilIdle()
+
+        val queued = async {
+            queue.submit(PrioritizedTaskQueue.Priority.HIGH) {}
+        }
+        advanceUntilIdle()
+        now = 5_000_000L
+
+        val diagnostics = queue.diagnostics()
+        assertEquals(1, diagnostics.queuedHigh)
+        assertEquals(0, diagnostics.queuedNormal)
+        assertEquals(1, diagnostics.running)
+        assertEquals(5L, diagnostics.oldestQueuedWaitMillis)
+
+        hold.complete(Unit)
+        running.await()
+        queued.await()
+
+        assertEquals(5L, queue.diagnostics().averageHighWaitMillis)
+    }
 }
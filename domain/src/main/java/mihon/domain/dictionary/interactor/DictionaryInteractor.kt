@@ -7,6 +7,7 @@ import mihon.domain.dictionary.repository.DictionaryRepository
 
 class DictionaryInteractor(
     private val dictionaryRepository: DictionaryRepository,
+    private val searchCache: DictionarySearchCache,
 ) {
     suspend fun getAllDictionaries(): List<Dictionary> {
         return dictionaryRepository.getAllDictionaries()
@@ -22,6 +23,7 @@ class DictionaryInteractor(
 
     suspend fun updateDictionary(dictionary: Dictionary) {
         dictionaryRepository.updateDictionary(dictionary)
+        searchCache.invalidate()
     }
 
     suspend fun createDictionary(
@@ -46,6 +48,7 @@ class DictionaryInteractor(
             storageReady = false,
         )
         val dictionaryId = dictionaryRepository.insertDictionary(dictionary)
+        searchCache.invalidate()
         return dictionary.copy(id = dictionaryId)
     }
 
@@ -59,6 +62,7 @@ class DictionaryInteractor(
         if (priorityToAdjust != null) {
             dictionaryRepository.bumpDownPrioritiesAbove(priorityToAdjust)
         }
+        searchCache.invalidate()
     }
 
     /**
@@ -70,6 +74,7 @@ class DictionaryInteractor(
         val priority2 = dict2.priority
         dictionaryRepository.updateDictionary(dict1.copy(priority = priority2))
         dictionaryRepository.updateDictionary(dict2.copy(priority = priority1))
+        searchCache.invalidate()
     }
 
     /**
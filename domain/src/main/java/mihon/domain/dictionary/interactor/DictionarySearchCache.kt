@@ -0,0 +1,124 @@
+package mihon.domain.dictionary.interactor
+
+import mihon.domain.dictionary.model.Dictionary
+import mihon.domain.dictionary.model.DictionaryTerm
+import mihon.domain.dictionary.model.DictionaryTermMeta
+
+/**
+ * Process-wide, size-bounded cache of [SearchDictionaryTerms] results.
+ *
+ * Entries are keyed by query text, the requested dictionary set and the parser language, so the
+ * reader popup, the search screen and the Anki flow all share hits. Anything that changes what a
+ * lookup can return (imports, migrations, enabling/disabling or reordering dictionaries) must call
+ * [invalidate]. The dictionary list itself is memoized too, so resolving a query's script and
+ * priorities needs no database round trip until the next invalidation.
+ */
+class DictionarySearchCache(
+    private val capacity: Int = DEFAULT_CAPACITY,
+) {
+    private data class Key(
+        val kind: Kind,
+        val query: String,
+        val dictionaryIds: Set<Long>,
+        val parserLanguage: ParserLanguage?,
+    )
+
+    private enum class Kind { SEARCH, FIRST_WORD, TERM_META }
+
+    private val entries = object : LinkedHashMap<Key, Any>(capacity, 0.75f, true) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<Key, Any>?): Boolean {
+            return size > capacity
+        }
+    }
+
+    private var dictionaries: List<Dictionary>? = null
+
+    // Bumped on every invalidation so that lookups started before it cannot repopulate stale data.
+    @Volatile
+    var generation: Long = 0L
+        private set
+
+    fun invalidate() {
+        synchronized(entries) {
+            generation++
+            entries.clear()
+            dictionaries = null
+        }
+    }
+
+    fun getDictionaries(): List<Dictionary>? {
+        return synchronized(entries) { dictionaries }
+    }
+
+    fun putDictionaries(dictionaries: List<Dictionary>, generation: Long) {
+        synchronized(entries) {
+            if (generation == this.generation) {
+                this.dictionaries = dictionaries
+            }
+        }
+    }
+
+    fun getSearch(query: String, dictionaryIds: Collection<Long>, parserLanguage: ParserLanguage): List<DictionaryTerm>? {
+        @Suppress("UNCHECKED_CAST")
+        return get(Key(Kind.SEARCH, query, dictionaryIds.toSet(), parserLanguage)) as List<DictionaryTerm>?
+    }
+
+    fun putSearch(
+        query: String,
+        dictionaryIds: Collection<Long>,
+        parserLanguage: ParserLanguage,
+        results: List<DictionaryTerm>,
+        generation: Long,
+    ) {
+        put(Key(Kind.SEARCH, query, dictionaryIds.toSet(), parserLanguage), results, generation)
+    }
+
+    fun getFirstWord(
+        sentence: String,
+        dictionaryIds: Collection<Long>,
+        parserLanguage: ParserLanguage,
+    ): SearchDictionaryTerms.FirstWordMatch? {
+        return get(Key(Kind.FIRST_WORD, sentence, dictionaryIds.toSet(), parserLanguage))
+            as SearchDictionaryTerms.FirstWordMatch?
+    }
+
+    fun putFirstWord(
+        sentence: String,
+        dictionaryIds: Collection<Long>,
+        parserLanguage: ParserLanguage,
+        match: SearchDictionaryTerms.FirstWordMatch,
+        generation: Long,
+    ) {
+        put(Key(Kind.FIRST_WORD, sentence, dictionaryIds.toSet(), parserLanguage), match, generation)
+    }
+
+    fun getTermMeta(expression: String, dictionaryIds: Set<Long>): List<DictionaryTermMeta>? {
+        @Suppress("UNCHECKED_CAST")
+        return get(Key(Kind.TERM_META, expression, dictionaryIds, null)) as List<DictionaryTermMeta>?
+    }
+
+    fun putTermMeta(
+        expression: String,
+        dictionaryIds: Set<Long>,
+        meta: List<DictionaryTermMeta>,
+        generation: Long,
+    ) {
+        put(Key(Kind.TERM_META, expression, dictionaryIds, null), meta, generation)
+    }
+
+    private fun get(key: Key): Any? {
+        return synchronized(entries) { entries[key] }
+    }
+
+    private fun put(key: Key, value: Any, generation: Long) {
+        synchronized(entries) {
+            if (generation == this.generation) {
+                entries[key] = value
+            }
+        }
+    }
+
+    companion object {
+        const val DEFAULT_CAPACITY = 512
+    }
+}
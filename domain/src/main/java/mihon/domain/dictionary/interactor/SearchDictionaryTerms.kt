@@ -21,6 +21,7 @@ import java.util.LinkedHashMap
 class SearchDictionaryTerms(
     private val dictionaryRepository: DictionaryRepository,
     private val dictionarySearchGateway: DictionarySearchGateway,
+    private val searchCache: DictionarySearchCache,
 ) {
     private data class NormalizedText(
         val text: String,
@@ -59,14 +60,22 @@ class SearchDictionaryTerms(
         this != Script.JAPANESE && this != Script.CHINESE && this != Script.KOREAN
 
     private suspend fun buildSearchContext(dictionaryIds: Collection<Long>): SearchContext {
-        val dictionaries = dictionaryRepository.getAllDictionaries()
-            .filter { it.id in dictionaryIds }
+        val dictionaries = getAllDictionaries().filter { it.id in dictionaryIds }
         return SearchContext(
             dictionariesById = dictionaries.associateBy { it.id },
             prioritiesById = dictionaries.associate { it.id to it.priority },
         )
     }
 
+    private suspend fun getAllDictionaries(): List<Dictionary> {
+        searchCache.getDictionaries()?.let { return it }
+
+        val generation = searchCache.generation
+        return dictionaryRepository.getAllDictionaries().also {
+            searchCache.putDictionaries(it, generation)
+        }
+    }
+
     private fun getAllowedScripts(dictionaryIds: List<Long>, context: SearchContext): Set<Script>? {
         val allowed = mutableSetOf<Script>()
         for (id in dictionaryIds) {
@@ -143,11 +152,28 @@ class SearchDictionaryTerms(
     ): List<DictionaryTerm> {
         if (dictionaryIds.isEmpty()) return emptyList()
 
-        val context = buildSearchContext(dictionaryIds)
         val trimmedQuery = query.trim { it in punctuationCharSet || it.isWhitespace() }
+        val context = buildSearchContext(dictionaryIds)
         val allowedScripts = getAllowedScripts(dictionaryIds, context)
         val script = resolveScript(trimmedQuery, parserLanguage, allowedScripts)
         val normalizedQuery = normalizeForSearch(trimmedQuery, script).text
+
+        // Keyed on the normalized text, so queries differing only in romaji or spacing share an entry.
+        searchCache.getSearch(normalizedQuery, dictionaryIds, parserLanguage)?.let { return it }
+
+        val generation = searchCache.generation
+        return searchUncached(normalizedQuery, script, dictionaryIds, context, allowedScripts).also {
+            searchCache.putSearch(normalizedQuery, dictionaryIds, parserLanguage, it, generation)
+        }
+    }
+
+    private suspend fun searchUncached(
+        normalizedQuery: String,
+        script: Script,
+        dictionaryIds: List<Long>,
+        context: SearchContext,
+        allowedScripts: Set<Script>?,
+    ): List<DictionaryTerm> {
         val isJapaneseAllowed = allowedScripts == null || Script.JAPANESE in allowedScripts
 
         val primaryResult = when (script) {
@@ -176,11 +202,15 @@ class SearchDictionaryTerms(
 
         val candidatesByTerm = candidateQueries.groupBy { it.term }
         val results = LinkedHashMap<String, DictionaryTerm>(minOf(candidateQueries.size * 4, MAX_RESULTS * 2))
+        val matchesByTerm = dictionarySearchGateway.exactSearchMany(
+            expressions = candidatesByTerm.keys.filter { it.isNotBlank() },
+            dictionaryIds = dictionaryIds,
+        )
 
         candidateLoop@ for ((term, groupedCandidates) in candidatesByTerm) {
             if (term.isBlank()) continue
 
-            val matches = dictionarySearchGateway.exactSearch(term, dictionaryIds)
+            val matches = matchesByTerm[term].orEmpty()
 
             for (entry in matches) {
                 val dbTerm = entry.term
@@ -345,6 +375,19 @@ class SearchDictionaryTerms(
     ): FirstWordMatch {
         if (sentence.isBlank() || dictionaryIds.isEmpty()) return FirstWordMatch("", 0, 0)
 
+        searchCache.getFirstWord(sentence, dictionaryIds, parserLanguage)?.let { return it }
+
+        val generation = searchCache.generation
+        return findFirstWordMatchUncached(sentence, dictionaryIds, parserLanguage).also {
+            searchCache.putFirstWord(sentence, dictionaryIds, parserLanguage, it, generation)
+        }
+    }
+
+    private suspend fun findFirstWordMatchUncached(
+        sentence: String,
+        dictionaryIds: List<Long>,
+        parserLanguage: ParserLanguage,
+    ): FirstWordMatch {
         val context = buildSearchContext(dictionaryIds)
         val allowedScripts = getAllowedScripts(dictionaryIds, context)
         val script = resolveScript(sentence, parserLanguage, allowedScripts)
@@ -381,15 +424,24 @@ class SearchDictionaryTerms(
         val normalized = normalizeForSearch(sanitized, Script.JAPANESE)
         val actualMaxLength = minOf(normalized.text.length, MAX_WORD_LENGTH)
 
-        for (len in actualMaxLength downTo 1) {
+        // Deinflect every prefix up front so all candidates resolve in a single batched query.
+        val candidatesByPrefix = (actualMaxLength downTo 1).map { len ->
             val substring = normalized.text.take(len)
+            substring to JapaneseDeinflector.deinflect(substring)
+        }
+        val matchesByTerm = dictionarySearchGateway.exactSearchMany(
+            expressions = candidatesByPrefix.flatMap { (_, candidates) ->
+                candidates.mapNotNull { candidate -> candidate.term.takeIf { it.isNotBlank() } }
+            },
+            dictionaryIds = dictionaryIds,
+        )
 
-            val candidates = JapaneseDeinflector.deinflect(substring)
+        for ((substring, candidates) in candidatesByPrefix) {
             for (candidate in candidates) {
                 val term = candidate.term
                 if (term.isBlank()) continue
 
-                val matches = dictionarySearchGateway.exactSearch(term, dictionaryIds).map { it.term }
+                val matches = matchesByTerm[term].orEmpty().map { it.term }
 
                 if (matches.isNotEmpty()) {
                     val candidatesForTerm = candidates.filter { c ->
@@ -668,7 +720,22 @@ class SearchDictionaryTerms(
         if (dictionaryIds.isEmpty()) {
             return expressions.associateWith { emptyList() }
         }
-        return dictionarySearchGateway.getTermMeta(expressions, dictionaryIds)
+
+        val dictionaryIdSet = dictionaryIds.toSet()
+        val cached = expressions.associateWith { searchCache.getTermMeta(it, dictionaryIdSet) }
+        val missing = cached.filterValues { it == null }.keys.toList()
+        if (missing.isEmpty()) {
+            return cached.mapValues { (_, meta) -> meta.orEmpty() }
+        }
+
+        val generation = searchCache.generation
+        val fetched = dictionarySearchGateway.getTermMeta(missing, dictionaryIds)
+        missing.forEach { expression ->
+            searchCache.putTermMeta(expression, dictionaryIdSet, fetched[expression].orEmpty(), generation)
+        }
+        return expressions.associateWith { expression ->
+            cached[expression] ?: fetched[expression].orEmpty()
+        }
     }
 
     private fun convertToKana(input: String): String {
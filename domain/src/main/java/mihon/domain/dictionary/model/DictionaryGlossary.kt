@@ -0,0 +1,39 @@
+package mihon.domain.dictionary.model
+
+/**
+ * Glossary handle for a [DictionaryTerm].
+ *
+ * Backends that return raw glossary JSON can hand out a lazily decoded handle so that only the
+ * terms that are actually rendered pay the parse cost. Lazily decoded handles compare by their
+ * [key] so that state diffing never forces a decode, and never equal an eagerly built handle.
+ */
+class DictionaryGlossary private constructor(
+    private val key: Any?,
+    decoder: () -> List<GlossaryEntry>,
+) {
+    val entries: List<GlossaryEntry> by lazy(LazyThreadSafetyMode.PUBLICATION, decoder)
+
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (other !is DictionaryGlossary) return false
+        if (key != null || other.key != null) return key == other.key
+        return entries == other.entries
+    }
+
+    override fun hashCode(): Int = key?.hashCode() ?: entries.hashCode()
+
+    override fun toString(): String = "DictionaryGlossary(key=$key)"
+
+    companion object {
+        fun of(entries: List<GlossaryEntry>): DictionaryGlossary {
+            return DictionaryGlossary(key = null) { entries }
+        }
+
+        /**
+         * @param key identity of the undecoded glossary, typically the raw JSON or a term id.
+         */
+        fun lazy(key: Any, decoder: () -> List<GlossaryEntry>): DictionaryGlossary {
+            return DictionaryGlossary(key, decoder)
+        }
+    }
+}
@@ -11,7 +11,35 @@ data class DictionaryTerm(
     val definitionTags: String?, // Comma-separated tags
     val rules: String?, // Comma-separated rules
     val score: Int,
-    val glossary: List<GlossaryEntry>, // Serialized tree per definition entry
+    val glossarySource: DictionaryGlossary, // Possibly undecoded glossary, see [glossary]
     val sequence: Long? = null,
     val termTags: String? = null, // Comma-separated tags
-)
+) {
+    constructor(
+        id: Long = 0L,
+        dictionaryId: Long,
+        expression: String,
+        reading: String,
+        definitionTags: String?,
+        rules: String?,
+        score: Int,
+        glossary: List<GlossaryEntry>,
+        sequence: Long? = null,
+        termTags: String? = null,
+    ) : this(
+        id = id,
+        dictionaryId = dictionaryId,
+        expression = expression,
+        reading = reading,
+        definitionTags = definitionTags,
+        rules = rules,
+        score = score,
+        glossarySource = DictionaryGlossary.of(glossary),
+        sequence = sequence,
+        termTags = termTags,
+    )
+
+    /** Serialized tree per definition entry, decoded on first access. */
+    val glossary: List<GlossaryEntry>
+        get() = glossarySource.entries
+}
@@ -31,6 +31,10 @@ interface DictionaryRepository {
 
     // Term operations
     suspend fun searchTerms(query: String, dictionaryIds: List<Long>): List<DictionaryTerm>
+    suspend fun searchTermsForQueries(
+        queries: List<String>,
+        dictionaryIds: List<Long>,
+    ): Map<String, List<DictionaryTerm>>
 
     // Term meta operations
     suspend fun getTermMetaForExpression(expression: String, dictionaryIds: List<Long>): List<DictionaryTermMeta>
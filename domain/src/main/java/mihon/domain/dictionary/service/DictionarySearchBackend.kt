@@ -9,6 +9,15 @@ interface DictionarySearchBackend {
         dictionaryIds: List<Long>,
     ): List<DictionarySearchEntry>
 
+    /**
+     * Resolves several exact-match queries in one round trip. The returned map contains an entry
+     * for every distinct expression, in the same order as [expressions].
+     */
+    suspend fun exactSearchMany(
+        expressions: List<String>,
+        dictionaryIds: List<Long>,
+    ): Map<String, List<DictionarySearchEntry>>
+
     suspend fun getTermMeta(
         expressions: List<String>,
         dictionaryIds: List<Long>,
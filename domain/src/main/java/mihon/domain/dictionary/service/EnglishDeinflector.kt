@@ -95,35 +95,38 @@ object EnglishDeinflector {
                 enqueueIfNew(current.derived(stripped, "possessive"))
             }
 
-            val firstTokenLower = term.substringBefore(' ').lowercase()
+            val firstTokenEnd = term.indexOf(' ').let { if (it < 0) term.length else it }
+            val firstToken = term.substring(0, firstTokenEnd)
+            val firstTokenLower = firstToken.lowercase()
             if (COPULA_FORMS.contains(firstTokenLower)) {
-                applyFirstToken(term) { "be" }?.let { converted ->
+                replaceFirstToken(term, firstToken, "be")?.let { converted ->
                     enqueueIfNew(current.derived(converted, "copula"))
                 }
             } else {
+                // Each model runs once per candidate; the results feed both the combined and per-class candidates.
+                val gerund = MODELS.fromGerund.maybeConvert(firstTokenLower)
+                val past = MODELS.fromPast.maybeConvert(firstTokenLower)
+                val participle = MODELS.fromParticiple.maybeConvert(firstTokenLower)
+                val present = MODELS.fromPresent.maybeConvert(firstTokenLower)
+
                 // Verb deconjugation on the first token: "looked up" -> "look up"
-                applyFirstToken(term) { token ->
-                    val w = token.lowercase()
-                    firstNonNullDistinct(
-                        w,
-                        MODELS.fromGerund.maybeConvert(w),
-                        MODELS.fromPast.maybeConvert(w),
-                        MODELS.fromParticiple.maybeConvert(w),
-                        MODELS.fromPresent.maybeConvert(w),
-                    )
-                }?.let { converted ->
-                    enqueueIfNew(current.derived(converted, reasonForVerb(term, converted)))
+                val combined = firstNonNullDistinct(firstTokenLower, gerund, past, participle, present)
+                replaceFirstToken(term, firstToken, combined)?.let { converted ->
+                    val reason = when (combined) {
+                        gerund -> "gerund"
+                        past -> "past"
+                        participle -> "participle"
+                        present -> "present"
+                        else -> "verb"
+                    }
+                    enqueueIfNew(current.derived(converted, reason))
                 }
 
                 // Additional verb candidates (one per inflection class)
-                applyFirstToken(term) { MODELS.fromGerund.maybeConvert(it.lowercase()) }
-                    ?.let { enqueueIfNew(current.derived(it, "gerund")) }
-                applyFirstToken(term) { MODELS.fromPast.maybeConvert(it.lowercase()) }
-                    ?.let { enqueueIfNew(current.derived(it, "past")) }
-                applyFirstToken(term) { MODELS.fromParticiple.maybeConvert(it.lowercase()) }
-                    ?.let { enqueueIfNew(current.derived(it, "participle")) }
-                applyFirstToken(term) { MODELS.fromPresent.maybeConvert(it.lowercase()) }
-                    ?.let { enqueueIfNew(current.derived(it, "present")) }
+                replaceFirstToken(term, firstToken, gerund)?.let { enqueueIfNew(current.derived(it, "gerund")) }
+                replaceFirstToken(term, firstToken, past)?.let { enqueueIfNew(current.derived(it, "past")) }
+                replaceFirstToken(term, firstToken, participle)?.let { enqueueIfNew(current.derived(it, "participle")) }
+                replaceFirstToken(term, firstToken, present)?.let { enqueueIfNew(current.derived(it, "present")) }
             }
 
             // Adjectives on the last token: "bigger" -> "big"
@@ -167,16 +170,10 @@ object EnglishDeinflector {
         )
     }
 
-    private fun applyFirstToken(term: String, transform: (String) -> String?): String? {
-        val idx = term.indexOf(' ')
-        return if (idx < 0) {
-            transform(term)?.takeIf { it != term }
-        } else {
-            val head = term.substring(0, idx)
-            val tail = term.substring(idx)
-            val newHead = transform(head)?.takeIf { it != head } ?: return null
-            newHead + tail
-        }
+    /** Replaces the leading [firstToken] of [term] with [newHead], or returns null if nothing changes. */
+    private fun replaceFirstToken(term: String, firstToken: String, newHead: String?): String? {
+        if (newHead == null || newHead == firstToken) return null
+        return newHead + term.substring(firstToken.length)
     }
 
     private fun applyLastToken(term: String, transform: (String) -> String?): String? {
@@ -216,20 +213,6 @@ object EnglishDeinflector {
         return null
     }
 
-    private fun reasonForVerb(from: String, to: String): String {
-        val fromToken = from.substringBefore(' ').lowercase()
-        val toToken = to.substringBefore(' ').lowercase()
-        if (fromToken == toToken) return "verb"
-        if (toToken == "be" && COPULA_FORMS.contains(fromToken)) return "copula"
-        return when (toToken) {
-            MODELS.fromGerund.maybeConvert(fromToken) -> "gerund"
-            MODELS.fromPast.maybeConvert(fromToken) -> "past"
-            MODELS.fromParticiple.maybeConvert(fromToken) -> "participle"
-            MODELS.fromPresent.maybeConvert(fromToken) -> "present"
-            else -> "verb"
-        }
-    }
-
     private const val MAX_CANDIDATES = 64
     private const val MAX_DEPTH = 4
 
@@ -298,51 +281,88 @@ object EnglishDeinflector {
 
     private fun toSingular(word: String): String {
         IRREGULAR_PLURAL_TO_SINGULAR[word]?.let { return it }
-        for (rule in SINGULAR_RULES) {
-            if (rule.regex.containsMatchIn(word)) {
-                return word.replace(rule.regex, rule.replacement)
+        if (word.isEmpty()) return word
+
+        val rules = SINGULAR_RULES_BY_LAST_CHAR[word.last()] ?: return word
+        for (rule in rules) {
+            if (rule.matches(word)) {
+                if (rule.strip == 0 && rule.append.isEmpty()) return word
+                return StringBuilder(word.length - rule.strip + rule.append.length)
+                    .append(word, 0, word.length - rule.strip)
+                    .append(rule.append)
+                    .toString()
             }
         }
         return word
     }
 
-    private data class RegexRule(val regex: Regex, val replacement: String)
-
-    private val SINGULAR_RULES: List<RegexRule> = listOf(
-        RegexRule(Regex("([^v])ies$", setOf(RegexOption.IGNORE_CASE)), "$1y"),
-        RegexRule(Regex("(ise)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(kn|[^o]l|w)ives$", setOf(RegexOption.IGNORE_CASE)), "$1ife"),
-        RegexRule(
-            Regex("^((?:ca|e|ha|(?:our|them|your)?se|she|wo)l|lea|loa|shea|thie)ves$", setOf(RegexOption.IGNORE_CASE)),
-            "$1f",
-        ),
-        RegexRule(Regex("^(dwar|handkerchie|hoo|scar|whar)ves$", setOf(RegexOption.IGNORE_CASE)), "$1f"),
-        RegexRule(Regex("(antenn|formul|nebul|vertebr|vit)ae$", setOf(RegexOption.IGNORE_CASE)), "$1a"),
-        RegexRule(Regex("(octop|vir|radi|nucle|fung|cact|stimul)(i)$", setOf(RegexOption.IGNORE_CASE)), "$1us"),
-        RegexRule(Regex("(buffal|tomat|tornad)(oes)$", setOf(RegexOption.IGNORE_CASE)), "$1o"),
-        RegexRule(Regex("(ause)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ease)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ious)es$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ouse)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ose)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(..ase)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(..[aeiu]s)es$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(vert|ind|cort)(ices)$", setOf(RegexOption.IGNORE_CASE)), "$1ex"),
-        RegexRule(Regex("(matr|append)(ices)$", setOf(RegexOption.IGNORE_CASE)), "$1ix"),
-        RegexRule(Regex("([xo]|ch|ss|sh)es$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("men$", setOf(RegexOption.IGNORE_CASE)), "man"),
-        RegexRule(Regex("(n)ews$", setOf(RegexOption.IGNORE_CASE)), "$1ews"),
-        RegexRule(Regex("([ti])a$", setOf(RegexOption.IGNORE_CASE)), "$1um"),
-        RegexRule(Regex("([^aeiouy]|qu)ies$", setOf(RegexOption.IGNORE_CASE)), "$1y"),
-        RegexRule(Regex("(s)eries$", setOf(RegexOption.IGNORE_CASE)), "$1eries"),
-        RegexRule(Regex("(m)ovies$", setOf(RegexOption.IGNORE_CASE)), "$1ovie"),
-        RegexRule(Regex("(cris|ax|test)es$", setOf(RegexOption.IGNORE_CASE)), "$1is"),
-        RegexRule(Regex("(alias|status)es$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ss)$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("(ic)s$", setOf(RegexOption.IGNORE_CASE)), "$1"),
-        RegexRule(Regex("s$", setOf(RegexOption.IGNORE_CASE)), ""),
+    /**
+     * Singularization rule: when a word ends with [suffix] and [guard] accepts it, the last [strip]
+     * characters are replaced with [append]. Rules are ported from the compromise plural regexes
+     * and are tried in declaration order; a rule with nothing to strip or append keeps the word.
+     */
+    private class SingularRule(
+        val suffix: String,
+        val strip: Int,
+        val append: String,
+        val guard: ((String) -> Boolean)? = null,
+    ) {
+        fun matches(word: String): Boolean = word.endsWith(suffix) && guard?.invoke(word) != false
+    }
+
+    /** Whether one of [options] sits directly before the trailing [suffixLength] characters. */
+    private fun String.precededBy(suffixLength: Int, vararg options: String): Boolean {
+        val end = length - suffixLength
+        return options.any { end >= it.length && regionMatches(end - it.length, it, 0, it.length) }
+    }
+
+    private fun String.charBeforeSuffix(suffixLength: Int): Char? = getOrNull(length - suffixLength - 1)
+
+    private val F_VES_SINGULARS: Set<String> = setOf(
+        "calves", "elves", "halves", "selves", "ourselves", "themselves", "yourselves", "shelves", "wolves",
+        "leaves", "loaves", "sheaves", "thieves",
+        "dwarves", "handkerchieves", "hooves", "scarves", "wharves",
+    )
+
+    private val SINGULAR_RULES: List<SingularRule> = listOf(
+        SingularRule("ies", 3, "y") { w -> w.charBeforeSuffix(3).let { it != null && it != 'v' } },
+        SingularRule("ises", 1, ""),
+        SingularRule("ives", 4, "ife") { w ->
+            w.precededBy(4, "kn", "w") || (w.precededBy(4, "l") && w.charBeforeSuffix(5).let { it != null && it != 'o' })
+        },
+        SingularRule("ves", 3, "f") { it in F_VES_SINGULARS },
+        SingularRule("ae", 1, "") { it.precededBy(2, "antenn", "formul", "nebul", "vertebr", "vit") },
+        SingularRule("i", 1, "us") { it.precededBy(1, "octop", "vir", "radi", "nucle", "fung", "cact", "stimul") },
+        SingularRule("oes", 2, "") { it.precededBy(3, "buffal", "tomat", "tornad") },
+        SingularRule("auses", 1, ""),
+        SingularRule("eases", 1, ""),
+        SingularRule("iouses", 2, ""),
+        SingularRule("ouses", 1, ""),
+        SingularRule("oses", 1, ""),
+        SingularRule("ases", 1, "") { it.length >= 6 },
+        SingularRule("ses", 2, "") { it.length >= 6 && it[it.length - 4] in "aeiu" },
+        SingularRule("ices", 4, "ex") { it.precededBy(4, "vert", "ind", "cort") },
+        SingularRule("ices", 4, "ix") { it.precededBy(4, "matr", "append") },
+        SingularRule("es", 2, "") { it.precededBy(2, "x", "o", "ch", "ss", "sh") },
+        SingularRule("men", 3, "man"),
+        SingularRule("news", 0, ""),
+        SingularRule("a", 1, "um") { it.precededBy(1, "t", "i") },
+        SingularRule("ies", 3, "y") { w ->
+            w.charBeforeSuffix(3).let { it != null && it !in "aeiouy" } || w.precededBy(3, "qu")
+        },
+        SingularRule("series", 0, ""),
+        SingularRule("movies", 1, ""),
+        SingularRule("es", 2, "is") { it.precededBy(2, "cris", "ax", "test") },
+        SingularRule("es", 2, "") { it.precededBy(2, "alias", "status") },
+        SingularRule("ss", 0, ""),
+        SingularRule("ics", 1, ""),
+        SingularRule("s", 1, ""),
     )
 
+    // Only rules whose suffix ends in the word's last character can match, so index them by it.
+    private val SINGULAR_RULES_BY_LAST_CHAR: Map<Char, List<SingularRule>> =
+        SINGULAR_RULES.groupBy { it.suffix.last() }
+
     private val IRREGULAR_PLURAL_TO_SINGULAR: Map<String, String> = buildMap {
         val singularToPlural = mapOf(
             "addendum" to "addenda",
@@ -443,31 +463,38 @@ object EnglishDeinflector {
 
     private data class Rule(val fromSuffix: String, val toSuffix: String, val priority: Int)
 
+    /**
+     * Suffix rewrite model compiled into a reversed-suffix trie, so a conversion walks the word
+     * once from its end instead of testing every rule with `endsWith`.
+     */
     private class ForwardModel(
         private val exceptions: Map<String, String>,
         rules: List<Rule>,
     ) {
-        private val rulesByLastChar: Map<Char, List<Rule>>
+        private val root = SuffixNode()
         private val emptySuffixRules: List<Rule>
+        private val maxSuffixLength: Int
 
         init {
-            val byLast = HashMap<Char, MutableList<Rule>>()
             val empty = ArrayList<Rule>()
+            var maxLength = 0
             for (rule in rules) {
                 val from = rule.fromSuffix
                 if (from.isEmpty()) {
                     empty.add(rule)
-                } else {
-                    byLast.getOrPut(from.last()) { ArrayList() }.add(rule)
+                    continue
                 }
+                var node = root
+                for (index in from.indices.reversed()) {
+                    node = node.children.getOrPut(from[index]) { SuffixNode() }
+                }
+                node.rules.add(rule)
+                maxLength = maxOf(maxLength, from.length)
             }
-            for ((k, v) in byLast) {
-                v.sortWith(compareByDescending<Rule> { it.fromSuffix.length }.thenBy { it.priority })
-                byLast[k] = v
-            }
-            empty.sortWith(compareByDescending<Rule> { it.fromSuffix.length }.thenBy { it.priority })
-            rulesByLastChar = byLast
+            sortNodeRules(root)
+            empty.sortBy { it.priority }
             emptySuffixRules = empty
+            maxSuffixLength = maxLength
         }
 
         fun maybeConvert(word: String): String? {
@@ -479,13 +506,23 @@ object EnglishDeinflector {
             exceptions[word]?.let { return it }
             if (word.isEmpty()) return word
 
-            rulesByLastChar[word.last()]?.let { rules ->
-                for (rule in rules) {
-                    if (word.endsWith(rule.fromSuffix)) {
-                        val stem = word.dropLast(rule.fromSuffix.length)
-                        val out = stem + rule.toSuffix
-                        if (out.isNotBlank()) return out
-                    }
+            // Collect matching suffix nodes along the path; longer suffixes win.
+            val path = arrayOfNulls<SuffixNode>(minOf(word.length, maxSuffixLength) + 1)
+            var depth = 0
+            var node = root
+            while (depth < path.size - 1) {
+                node = node.children[word[word.length - 1 - depth]] ?: break
+                depth++
+                path[depth] = node
+            }
+
+            for (length in depth downTo 1) {
+                for (rule in path[length]!!.rules) {
+                    val out = StringBuilder(word.length - length + rule.toSuffix.length)
+                        .append(word, 0, word.length - length)
+                        .append(rule.toSuffix)
+                        .toString()
+                    if (out.isNotBlank()) return out
                 }
             }
 
@@ -496,6 +533,16 @@ object EnglishDeinflector {
 
             return word
         }
+
+        private fun sortNodeRules(node: SuffixNode) {
+            node.rules.sortBy { it.priority }
+            node.children.values.forEach(::sortNodeRules)
+        }
+
+        private class SuffixNode {
+            val children = HashMap<Char, SuffixNode>(4)
+            val rules = ArrayList<Rule>(1)
+        }
     }
 
     private class SuffixModel(
@@ -55,16 +55,18 @@ const val ALL_STEMS = STEM_REN or STEM_MIZENKEI or STEM_E or STEM_A or STEM_KU o
 /**
  * Represents a single deinflection rule.
  */
-private data class Rule(
+internal data class Rule(
     val fromEnding: String,
     val toEnding: String,
     val fromTags: Long,
     val toTags: Long,
     val detail: String,
     val type: RuleType,
-)
+) {
+    val isSilent: Boolean = detail.isBlank()
+}
 
-private enum class RuleType {
+internal enum class RuleType {
     STANDARD, // Normal rule, can chain
     NEVER_FINAL, // Result cannot be a dictionary form
     ONLY_FINAL, // Can only apply to original input
@@ -72,6 +74,95 @@ private enum class RuleType {
     REWRITE, // Only applies when the entire term matches (Deconjugator.cs rewriterule)
 }
 
+/**
+ * Node of the reversed-suffix rule trie. Children are keyed by the character preceding the
+ * suffix matched so far, kept sorted for binary search so lookups never box a [Char].
+ */
+private class SuffixNode {
+    private var keys = CharArray(0)
+    private var children = arrayOfNulls<SuffixNode>(0)
+    var rules: List<Rule> = emptyList()
+
+    fun child(char: Char): SuffixNode? {
+        val index = keys.binarySearch(char)
+        return if (index >= 0) children[index] else null
+    }
+
+    fun getOrCreateChild(char: Char): SuffixNode {
+        val index = keys.binarySearch(char)
+        if (index >= 0) return children[index]!!
+
+        val insertAt = -(index + 1)
+        val node = SuffixNode()
+        keys = CharArray(keys.size + 1).also { grown ->
+            keys.copyInto(grown, 0, 0, insertAt)
+            grown[insertAt] = char
+            keys.copyInto(grown, insertAt + 1, insertAt)
+        }
+        children = arrayOfNulls<SuffixNode>(children.size + 1).also { grown ->
+            children.copyInto(grown, 0, 0, insertAt)
+            grown[insertAt] = node
+            children.copyInto(grown, insertAt + 1, insertAt)
+        }
+        return node
+    }
+}
+
+/**
+ * Minimal open-addressing set of non-negative longs, used to dedupe BFS states without boxing.
+ */
+private class LongHashSet {
+    private var slots = LongArray(INITIAL_CAPACITY).apply { fill(EMPTY) }
+    private var size = 0
+
+    fun contains(value: Long): Boolean {
+        var index = indexFor(value, slots.size)
+        while (true) {
+            val slot = slots[index]
+            if (slot == EMPTY) return false
+            if (slot == value) return true
+            index = (index + 1) and (slots.size - 1)
+        }
+    }
+
+    /** Returns `true` if [value] was not already present. */
+    fun add(value: Long): Boolean {
+        if ((size + 1) * 2 > slots.size) grow()
+        var index = indexFor(value, slots.size)
+        while (true) {
+            val slot = slots[index]
+            if (slot == value) return false
+            if (slot == EMPTY) {
+                slots[index] = value
+                size++
+                return true
+            }
+            index = (index + 1) and (slots.size - 1)
+        }
+    }
+
+    private fun grow() {
+        val old = slots
+        slots = LongArray(old.size * 2).apply { fill(EMPTY) }
+        for (value in old) {
+            if (value == EMPTY) continue
+            var index = indexFor(value, slots.size)
+            while (slots[index] != EMPTY) index = (index + 1) and (slots.size - 1)
+            slots[index] = value
+        }
+    }
+
+    private fun indexFor(value: Long, capacity: Int): Int {
+        val mixed = value * -0x61c8864680b583ebL
+        return (mixed xor (mixed ushr 32)).toInt() and (capacity - 1)
+    }
+
+    private companion object {
+        const val INITIAL_CAPACITY = 64
+        const val EMPTY = -1L
+    }
+}
+
 /**
  * Represents a deinflection candidate.
  */
@@ -162,7 +253,7 @@ object JapaneseDeinflector {
     fun deinflect(source: String): List<Candidate> {
         if (source.isBlank()) return emptyList()
 
-        val results = mutableMapOf<String, Candidate>()
+        val results = LinkedHashMap<String, Candidate>()
 
         // Add the source itself as a candidate
         results[source] = Candidate(
@@ -176,7 +267,8 @@ object JapaneseDeinflector {
         val queue = ArrayDeque<Candidate>()
         queue.add(results[source]!!)
 
-        val processed = mutableSetOf<String>()
+        val termIds = HashMap<String, Int>()
+        val processed = LongHashSet()
 
         while (queue.isNotEmpty()) {
             val current = queue.removeFirst()
@@ -184,19 +276,17 @@ object JapaneseDeinflector {
             // This avoids runaway expansions.
             if (current.term.length > source.length + 10) continue
 
-            val processKey = "${current.term}:${current.conditions}"
-            if (processKey in processed) continue
-            processed.add(processKey)
+            if (!processed.add(processKey(termIds, current.term, current.conditions))) continue
 
             val term = current.term
             val termLen = term.length
 
-            // Process rules by checking suffixes of the current term
-            for (suffixLen in 0..minOf(termLen, MAX_SUFFIX_LENGTH)) {
-                val suffix = if (suffixLen == 0) "" else term.takeLast(suffixLen)
-                val rulesForSuffix = RULES_BY_SUFFIX[suffix] ?: continue
-
-                for (rule in rulesForSuffix) {
+            // Walk the reversed-suffix trie from the end of the term; each depth holds the rules
+            // whose ending is exactly that suffix, so no suffix strings are materialized.
+            var node: SuffixNode? = RULE_TRIE
+            var suffixLen = 0
+            while (node != null) {
+                for (rule in node.rules) {
                     if (rule.type == RuleType.ONLY_FINAL && current.hasAppliedRule) {
                         continue
                     }
@@ -208,12 +298,12 @@ object JapaneseDeinflector {
                     }
 
                     // Rewrite rules are only applicable when the entire term matches the pattern.
-                    if (rule.type == RuleType.REWRITE && term != rule.fromEnding) {
+                    if (rule.type == RuleType.REWRITE && termLen != suffixLen) {
                         continue
                     }
 
                     if (!current.hasAppliedRule && current.conditions == 0L && rule.type == RuleType.STANDARD &&
-                        rule.detail.isBlank()
+                        rule.isSilent
                     ) {
                         continue
                     }
@@ -229,18 +319,21 @@ object JapaneseDeinflector {
                         continue
                     }
 
-                    val stem = term.dropLast(suffixLen)
-                    val newTerm = stem + rule.toEnding
-
-                    if (newTerm.isEmpty()) continue
+                    val stemLen = termLen - suffixLen
+                    if (stemLen == 0 && rule.toEnding.isEmpty()) continue
 
-                    val newReasons = if (rule.detail.isNotBlank()) {
-                        ArrayDeque(current.reasons).also { it.addLast(rule.detail) }
-                    } else {
-                        ArrayDeque(current.reasons)
-                    }
+                    val newTerm = StringBuilder(stemLen + rule.toEnding.length)
+                        .append(term, 0, stemLen)
+                        .append(rule.toEnding)
+                        .toString()
                     val newConditions = rule.fromTags
 
+                    if (processed.contains(processKey(termIds, newTerm, newConditions))) continue
+
+                    val newReasons = ArrayDeque<String>(current.reasons.size + 1)
+                    newReasons.addAll(current.reasons)
+                    if (!rule.isSilent) newReasons.addLast(rule.detail)
+
                     val outputIsAnyStem = (newConditions and ALL_STEMS) != 0L
                     val outputIsDictionaryForm = !outputIsAnyStem && newConditions != 0L
                     val outputIsRenyouStem = (newConditions and STEM_REN) != 0L
@@ -252,9 +345,6 @@ object JapaneseDeinflector {
                         RuleType.STANDARD, RuleType.CONTEXT, RuleType.REWRITE -> !outputIsAnyStem || outputIsRenyouStem
                     }
 
-                    val newProcessKey = "$newTerm:$newConditions"
-                    if (newProcessKey in processed) continue
-
                     val newCandidate = Candidate(
                         term = newTerm,
                         conditions = newConditions,
@@ -303,6 +393,10 @@ object JapaneseDeinflector {
                         }
                     }
                 }
+
+                if (suffixLen == termLen) break
+                suffixLen++
+                node = node.child(term[termLen - suffixLen])
             }
         }
 
@@ -310,7 +404,7 @@ object JapaneseDeinflector {
         return results.values.filter { it.canBeFinal }.toList()
     }
 
-    private fun passesContextRule(rule: Rule, current: Candidate, term: String, suffixLen: Int): Boolean {
+    internal fun passesContextRule(rule: Rule, current: Candidate, term: String, suffixLen: Int): Boolean {
         // Block "teru (teiru)" only when the current tag is exactly stem-ren.
         // Don't treat "さす" as "(a-stem)+す".
         return when {
@@ -325,13 +419,30 @@ object JapaneseDeinflector {
         }
     }
 
-    private const val MAX_SUFFIX_LENGTH = 9 // Longest suffix in rules
+    /**
+     * Packs a (term, conditions) pair into a single [Long] for the processed set. Terms are
+     * interned to dense ids per call and rule tags only use the low 32 bits.
+     */
+    private fun processKey(termIds: HashMap<String, Int>, term: String, conditions: Long): Long {
+        val termId = termIds.getOrPut(term) { termIds.size }
+        return (termId.toLong() shl 32) or (conditions and 0xFFFFFFFFL)
+    }
 
-    private val RULES_BY_SUFFIX: Map<String, List<Rule>> by lazy {
-        ALL_RULES.groupBy { it.fromEnding }
+    private val RULE_TRIE: SuffixNode by lazy {
+        val root = SuffixNode()
+        for (rule in ALL_RULES) {
+            check(rule.fromTags ushr 32 == 0L) { "Rule tags must fit in 32 bits: ${rule.fromEnding}" }
+            var node = root
+            for (index in rule.fromEnding.indices.reversed()) {
+                node = node.getOrCreateChild(rule.fromEnding[index])
+            }
+            node.rules += rule
+        }
+        root
     }
 
-    private val ALL_RULES: List<Rule> = buildList {
+    // Internal so tests can run the rule table through the reference suffix-map implementation.
+    internal val ALL_RULES: List<Rule> = buildList {
         // Izenkei (realis/conditional stem) - neverfinalrule
         add(Rule("け", "く", V5K, STEM_E, "(izenkei)", RuleType.NEVER_FINAL))
         add(Rule("せ", "す", V5S, STEM_E, "(izenkei)", RuleType.NEVER_FINAL))
@@ -0,0 +1,13 @@
+package mihon.domain.ocr.interactor
+
+import mihon.domain.ocr.model.OcrPageResult
+import mihon.domain.ocr.repository.OcrRepository
+
+class CacheOcrPages(
+    private val ocrRepository: OcrRepository,
+) {
+    suspend fun await(results: List<OcrPageResult>) {
+        if (results.isEmpty()) return
+        ocrRepository.cachePages(results)
+    }
+}
@@ -0,0 +1,11 @@
+package mihon.domain.ocr.interactor
+
+import mihon.domain.ocr.repository.OcrRepository
+
+class PrefetchChapterOcr(
+    private val ocrRepository: OcrRepository,
+) {
+    suspend fun await(chapterId: Long) {
+        ocrRepository.prefetchChapter(chapterId)
+    }
+}
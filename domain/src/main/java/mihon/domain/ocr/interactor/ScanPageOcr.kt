@@ -3,6 +3,7 @@ package mihon.domain.ocr.interactor
 import mihon.domain.ocr.model.OcrImage
 import mihon.domain.ocr.model.OcrPageResult
 import mihon.domain.ocr.repository.OcrRepository
+import tachiyomi.core.common.util.system.ReadingDirection
 
 class ScanPageOcr(
     private val ocrRepository: OcrRepository,
@@ -11,7 +12,9 @@ class ScanPageOcr(
         chapterId: Long,
         pageIndex: Int,
         image: OcrImage,
+        direction: ReadingDirection,
+        persist: Boolean = true,
     ): OcrPageResult {
-        return ocrRepository.scanPage(chapterId, pageIndex, image)
+        return ocrRepository.scanPage(chapterId, pageIndex, image, direction, persist)
     }
 }
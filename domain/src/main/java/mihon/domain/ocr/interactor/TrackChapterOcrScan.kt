@@ -0,0 +1,15 @@
+package mihon.domain.ocr.interactor
+
+import mihon.domain.ocr.repository.OcrRepository
+
+class TrackChapterOcrScan(
+    private val ocrRepository: OcrRepository,
+) {
+    suspend fun start(chapterId: Long): Long {
+        return ocrRepository.startChapterScan(chapterId)
+    }
+
+    suspend fun finish(chapterId: Long, startedAt: Long) {
+        ocrRepository.finishChapterScan(chapterId, startedAt)
+    }
+}
@@ -0,0 +1,74 @@
+package mihon.domain.ocr.model
+
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * A page or region image handed to OCR.
+ *
+ * Platform layers wrap their own pixel storage (e.g. a decoded bitmap) instead of copying it into
+ * an [IntArray]. Images are reference counted: the creator owns the first reference, anything that
+ * keeps the image past a call [retain]s it, and the backing storage is freed once the last
+ * reference is [release]d.
+ */
+abstract class OcrImage protected constructor(
+    val width: Int,
+    val height: Int,
+) : AutoCloseable {
+    private val references = AtomicInteger(1)
+
+    init {
+        require(width > 0 && height > 0) { "OCR image dimensions must be positive" }
+    }
+
+    val isReleased: Boolean
+        get() = references.get() <= 0
+
+    /** Copies the image out as ARGB_8888 pixels, for consumers that cannot use the backing storage. */
+    abstract fun copyPixels(): IntArray
+
+    /** Frees the backing storage; called exactly once, when the last reference is released. */
+    protected abstract fun onReleased()
+
+    fun retain(): OcrImage {
+        while (true) {
+            val current = references.get()
+            check(current > 0) { "OCR image was already released" }
+            if (references.compareAndSet(current, current + 1)) return this
+        }
+    }
+
+    fun release() {
+        val remaining = references.decrementAndGet()
+        check(remaining >= 0) { "OCR image was released more times than it was retained" }
+        if (remaining == 0) {
+            onReleased()
+        }
+    }
+
+    override fun close() {
+        release()
+    }
+
+    companion object {
+        /** Wraps an existing ARGB_8888 pixel array without copying it. */
+        fun fromPixels(width: Int, height: Int, pixels: IntArray): OcrImage {
+            return PixelOcrImage(width, height, pixels)
+        }
+    }
+}
+
+private class PixelOcrImage(
+    width: Int,
+    height: Int,
+    private val pixels: IntArray,
+) : OcrImage(width, height) {
+    init {
+        require(pixels.size == width * height) {
+            "OCR image pixels size must match width * height"
+        }
+    }
+
+    override fun copyPixels(): IntArray = pixels.copyOf()
+
+    override fun onReleased() = Unit
+}
@@ -1,18 +1,5 @@
 package mihon.domain.ocr.model
 
-data class OcrImage(
-    val width: Int,
-    val height: Int,
-    val pixels: IntArray,
-) {
-    init {
-        require(width > 0 && height > 0) { "OCR image dimensions must be positive" }
-        require(pixels.size == width * height) {
-            "OCR image pixels size must match width * height"
-        }
-    }
-}
-
 data class OcrBoundingBox(
     val left: Float,
     val top: Float,
@@ -49,6 +36,8 @@ data class OcrPageResult(
     val imageWidth: Int,
     val imageHeight: Int,
     val regions: List<OcrRegion>,
+    /** Hash of the decoded page pixels; lets identical images elsewhere reuse this result. */
+    val contentHash: String? = null,
 ) {
     val text: String
         get() = regions.joinToString(separator = " ") { flattenOcrTextForQuery(it.text) }.trim()
@@ -2,23 +2,50 @@ package mihon.domain.ocr.repository
 
 import mihon.domain.ocr.model.OcrImage
 import mihon.domain.ocr.model.OcrPageResult
+import tachiyomi.core.common.util.system.ReadingDirection
 
 interface OcrRepository {
     suspend fun recognizeText(image: OcrImage): String
 
+    /**
+     * Scans a page, ordering its regions for [direction]. With [persist] unset the result is only
+     * returned, and the caller is expected to hand it to [cachePages] later, e.g. to batch cache
+     * writes off the scanning path.
+     */
     suspend fun scanPage(
         chapterId: Long,
         pageIndex: Int,
         image: OcrImage,
+        direction: ReadingDirection,
+        persist: Boolean = true,
     ): OcrPageResult
 
+    /** Writes already scanned pages to the OCR cache in a single transaction. */
+    suspend fun cachePages(results: List<OcrPageResult>)
+
     suspend fun getCachedPage(
         chapterId: Long,
         pageIndex: Int,
     ): OcrPageResult?
 
+    /** Warms an in-memory index of the chapter's cached pages so [getCachedPage] avoids the database. */
+    suspend fun prefetchChapter(chapterId: Long)
+
+    /** Returns the chapters among [chapterIds] whose last scan covered every page. */
     suspend fun getCachedChapterIds(chapterIds: Collection<Long>): Set<Long>
 
+    /**
+     * Marks [chapterId] as not fully scanned while a scan of it runs, and returns a start token
+     * for [finishChapterScan].
+     */
+    suspend fun startChapterScan(chapterId: Long): Long
+
+    /**
+     * Marks [chapterId] as fully scanned and drops its cached pages that the scan started with
+     * [startedAt] did not rewrite.
+     */
+    suspend fun finishChapterScan(chapterId: Long, startedAt: Long)
+
     suspend fun clearCachedChapter(chapterId: Long)
 
     suspend fun clearCache()
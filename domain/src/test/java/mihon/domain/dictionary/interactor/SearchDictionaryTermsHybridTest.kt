@@ -21,6 +21,7 @@ import org.junit.jupiter.api.Test
 class SearchDictionaryTermsHybridTest {
     private lateinit var dictionaryRepository: DictionaryRepository
     private lateinit var dictionarySearchGateway: DictionarySearchGateway
+    private lateinit var searchCache: DictionarySearchCache
     private lateinit var searchDictionaryTerms: SearchDictionaryTerms
 
     @BeforeEach
@@ -30,10 +31,15 @@ class SearchDictionaryTermsHybridTest {
 
         coEvery { dictionaryRepository.getAllDictionaries() } returns emptyList()
         coEvery { dictionarySearchGateway.exactSearch(any(), any()) } returns emptyList()
+        coEvery { dictionarySearchGateway.exactSearchMany(any(), any()) } coAnswers {
+            val ids = secondArg<List<Long>>()
+            firstArg<List<String>>().distinct().associateWith { dictionarySearchGateway.exactSearch(it, ids) }
+        }
         coEvery { dictionarySearchGateway.lookup(any(), any(), any()) } returns emptyList<DictionaryLookupMatch>()
         coEvery { dictionarySearchGateway.getTermMeta(any(), any()) } returns emptyMap()
 
-        searchDictionaryTerms = SearchDictionaryTerms(dictionaryRepository, dictionarySearchGateway)
+        searchCache = DictionarySearchCache()
+        searchDictionaryTerms = SearchDictionaryTerms(dictionaryRepository, dictionarySearchGateway, searchCache)
     }
 
     @Test
@@ -599,4 +605,75 @@ class SearchDictionaryTermsHybridTest {
         coVerify(exactly = 1) { dictionarySearchGateway.exactSearch("looked", listOf(1L)) }
         coVerify(atLeast = 1) { dictionarySearchGateway.exactSearch("look", listOf(1L)) }
     }
+
+    @Test
+    fun `legacy japanese search resolves deinflection candidates in one batched query`() = runTest {
+        val legacyDictionary = Dictionary(
+            id = 1L,
+            title = "Legacy Japanese",
+            revision = "1",
+            version = 3,
+            sourceLanguage = "ja",
+            backend = DictionaryBackend.LEGACY_DB,
+        )
+        val term = DictionaryTerm(
+            dictionaryId = 1L,
+            expression = "食べる",
+            reading = "たべる",
+            definitionTags = null,
+            rules = "v1",
+            score = 0,
+            glossary = emptyList(),
+            termTags = null,
+        )
+
+        coEvery { dictionaryRepository.getAllDictionaries() } returns listOf(legacyDictionary)
+        coEvery { dictionarySearchGateway.exactSearchMany(any(), listOf(1L)) } coAnswers {
+            firstArg<List<String>>().associateWith { expression ->
+                if (expression == "食べる") listOf(DictionarySearchEntry(term, emptyList())) else emptyList()
+            }
+        }
+
+        val results = searchDictionaryTerms.search("食べた", listOf(1L))
+
+        results.map { it.expression } shouldBe listOf("食べる")
+        coVerify(exactly = 1) { dictionarySearchGateway.exactSearchMany(any(), listOf(1L)) }
+        coVerify(exactly = 0) { dictionarySearchGateway.exactSearch(any(), any()) }
+    }
+
+    @Test
+    fun `repeat searches are served from the cache until it is invalidated`() = runTest {
+        val englishDictionary = Dictionary(
+            id = 1L,
+            title = "English",
+            revision = "1",
+            version = 3,
+            sourceLanguage = "en",
+            backend = DictionaryBackend.HOSHI,
+            storageReady = true,
+        )
+        val term = DictionaryTerm(
+            dictionaryId = 1L,
+            expression = "apple",
+            reading = "apple",
+            definitionTags = null,
+            rules = null,
+            score = 0,
+            glossary = emptyList(),
+            termTags = null,
+        )
+
+        coEvery { dictionaryRepository.getAllDictionaries() } returns listOf(englishDictionary)
+        coEvery { dictionarySearchGateway.exactSearch("apple", listOf(1L)) } returns listOf(
+            DictionarySearchEntry(term = term, termMeta = emptyList()),
+        )
+
+        searchDictionaryTerms.search("apple", listOf(1L)).map { it.expression } shouldBe listOf("apple")
+        searchDictionaryTerms.search(" apple。", listOf(1L)).map { it.expression } shouldBe listOf("apple")
+        coVerify(exactly = 1) { dictionarySearchGateway.exactSearch("apple", listOf(1L)) }
+
+        searchCache.invalidate()
+        searchDictionaryTerms.search("apple", listOf(1L))
+        coVerify(exactly = 2) { dictionarySearchGateway.exactSearch("apple", listOf(1L)) }
+    }
 }
@@ -58,10 +58,14 @@ class SentenceParserTest {
                 dictionaryRepository.searchTerms(firstArg(), secondArg()).map { DictionarySearchEntry(it, emptyList()) }
             }
         }
+        coEvery { dictionarySearchGateway.exactSearchMany(any(), any()) } coAnswers {
+            val ids = secondArg<List<Long>>()
+            firstArg<List<String>>().distinct().associateWith { dictionarySearchGateway.exactSearch(it, ids) }
+        }
         coEvery { dictionarySearchGateway.lookup(any(), any(), any()) } returns emptyList<DictionaryLookupMatch>()
         coEvery { dictionarySearchGateway.getTermMeta(any(), any()) } returns emptyMap()
 
-        searchDictionaryTerms = SearchDictionaryTerms(dictionaryRepository, dictionarySearchGateway)
+        searchDictionaryTerms = SearchDictionaryTerms(dictionaryRepository, dictionarySearchGateway, DictionarySearchCache())
     }
 
     @Test
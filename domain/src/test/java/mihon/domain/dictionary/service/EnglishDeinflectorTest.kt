@@ -0,0 +1,46 @@
+package mihon.domain.dictionary.service
+
+import io.kotest.matchers.collections.shouldBeEmpty
+import io.kotest.matchers.collections.shouldContain
+import io.kotest.matchers.collections.shouldNotContain
+import org.junit.jupiter.api.Test
+
+class EnglishDeinflectorTest {
+
+    private fun terms(source: String): List<String> = EnglishDeinflector.deinflect(source).map { it.term }
+
+    @Test
+    fun `blank input yields no candidates`() {
+        EnglishDeinflector.deinflect(" ").shouldBeEmpty()
+    }
+
+    @Test
+    fun `regular and irregular plurals singularize`() {
+        terms("cities") shouldContain "city"
+        terms("boxes") shouldContain "box"
+        terms("knives") shouldContain "knife"
+        terms("wolves") shouldContain "wolf"
+        terms("statuses") shouldContain "status"
+        terms("children") shouldContain "child"
+    }
+
+    @Test
+    fun `guarded plural rules pick the matching rewrite`() {
+        terms("vertices") shouldContain "vertex"
+        terms("vertices") shouldNotContain "vertix"
+        terms("tomatoes") shouldContain "tomato"
+    }
+
+    @Test
+    fun `verb inflections deinflect on the first token`() {
+        terms("looked") shouldContain "look"
+        terms("Looked up") shouldContain "look up"
+        terms("was") shouldContain "be"
+    }
+
+    @Test
+    fun `comparatives reduce to the base adjective`() {
+        terms("bigger") shouldContain "big"
+        terms("happiest") shouldContain "happy"
+    }
+}
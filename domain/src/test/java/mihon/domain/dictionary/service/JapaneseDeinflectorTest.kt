@@ -0,0 +1,210 @@
+package mihon.domain.dictionary.service
+
+import io.kotest.matchers.collections.shouldBeEmpty
+import io.kotest.matchers.collections.shouldContain
+import io.kotest.matchers.nulls.shouldNotBeNull
+import io.kotest.matchers.shouldBe
+import org.junit.jupiter.api.Test
+import kotlin.system.measureNanoTime
+
+class JapaneseDeinflectorTest {
+
+    @Test
+    fun `blank input yields no candidates`() {
+        JapaneseDeinflector.deinflect("  ").shouldBeEmpty()
+    }
+
+    @Test
+    fun `source is always returned as an unconditioned candidate`() {
+        val source = JapaneseDeinflector.deinflect("食べた").first()
+
+        source.term shouldBe "食べた"
+        source.conditions shouldBe 0L
+    }
+
+    @Test
+    fun `past tense ichidan verb deinflects to dictionary form`() {
+        val candidate = JapaneseDeinflector.deinflect("食べた").firstOrNull { it.term == "食べる" }
+
+        candidate.shouldNotBeNull()
+        (candidate.conditions and V1) shouldBe V1
+        candidate.reasons.toList() shouldContain "past"
+    }
+
+    @Test
+    fun `chained causative passive past deinflects to dictionary form`() {
+        val terms = JapaneseDeinflector.deinflect("食べさせられた").map { it.term }
+
+        terms shouldContain "食べさせる"
+        terms shouldContain "食べる"
+    }
+
+    @Test
+    fun `godan negative deinflects through the a-stem`() {
+        val candidate = JapaneseDeinflector.deinflect("行かない").firstOrNull { it.term == "行く" }
+
+        candidate.shouldNotBeNull()
+        (candidate.conditions and V5K) shouldBe V5K
+    }
+
+    @Test
+    fun `trie walk matches the suffix map baseline over a word corpus`() {
+        val corpus = buildCorpus()
+
+        for (word in corpus) {
+            JapaneseDeinflector.deinflect(word) shouldBe BaselineDeinflector.deinflect(word)
+        }
+
+        // Warm both paths up before timing so JIT compilation does not skew the comparison.
+        repeat(TIMING_WARMUP_ROUNDS) {
+            corpus.forEach(BaselineDeinflector::deinflect)
+            corpus.forEach(JapaneseDeinflector::deinflect)
+        }
+        val baselineNanos = measureNanoTime {
+            repeat(TIMING_ROUNDS) { corpus.forEach(BaselineDeinflector::deinflect) }
+        }
+        val trieNanos = measureNanoTime {
+            repeat(TIMING_ROUNDS) { corpus.forEach(JapaneseDeinflector::deinflect) }
+        }
+        val lookups = corpus.size * TIMING_ROUNDS
+        println(
+            "Deinflected $lookups words: baseline ${baselineNanos / lookups} ns/word, " +
+                "trie ${trieNanos / lookups} ns/word",
+        )
+    }
+
+    private fun buildCorpus(): List<String> {
+        val stems = listOf("食べ", "見", "行か", "行き", "書い", "読ま", "読ん", "し", "さ", "来", "高", "高く", "静か", "泳い")
+        val endings = listOf(
+            "", "る", "た", "だ", "ない", "ます", "ました", "ません", "なかった", "させられた", "られる", "せる",
+            "ている", "ていた", "てる", "ちゃった", "たい", "たくない", "かった", "くない", "れば", "よう", "ろ",
+            "て", "で", "そう", "さ", "す", "ず", "ぬ", "まい", "なきゃ",
+        )
+        return stems.flatMap { stem -> endings.map { stem + it } } +
+            listOf("する", "した", "される", "くる", "きた", "こない", "ある", "あった", "いらっしゃいます", "問うた")
+    }
+
+    /**
+     * Reference implementation that scans every suffix length against a map of rule endings, as
+     * [JapaneseDeinflector] did before compiling the rules into a trie.
+     */
+    private object BaselineDeinflector {
+        private const val MAX_SUFFIX_LENGTH = 9
+
+        private val rulesBySuffix = JapaneseDeinflector.ALL_RULES.groupBy { it.fromEnding }
+
+        fun deinflect(source: String): List<Candidate> {
+            if (source.isBlank()) return emptyList()
+
+            val results = mutableMapOf<String, Candidate>()
+            results[source] = Candidate(term = source, conditions = 0L)
+
+            val queue = ArrayDeque<Candidate>()
+            queue.add(results[source]!!)
+
+            val processed = mutableSetOf<String>()
+
+            while (queue.isNotEmpty()) {
+                val current = queue.removeFirst()
+                if (current.term.length > source.length + 10) continue
+
+                val processKey = "${current.term}:${current.conditions}"
+                if (processKey in processed) continue
+                processed.add(processKey)
+
+                val term = current.term
+                val termLen = term.length
+
+                for (suffixLen in 0..minOf(termLen, MAX_SUFFIX_LENGTH)) {
+                    val suffix = if (suffixLen == 0) "" else term.takeLast(suffixLen)
+                    val rulesForSuffix = rulesBySuffix[suffix] ?: continue
+
+                    for (rule in rulesForSuffix) {
+                        if (rule.type == RuleType.ONLY_FINAL && current.hasAppliedRule) continue
+                        if (rule.type == RuleType.NEVER_FINAL && !current.hasAppliedRule) continue
+                        if (rule.type == RuleType.REWRITE && term != rule.fromEnding) continue
+                        if (!current.hasAppliedRule && current.conditions == 0L && rule.type == RuleType.STANDARD &&
+                            rule.detail.isBlank()
+                        ) {
+                            continue
+                        }
+                        if (rule.type == RuleType.CONTEXT &&
+                            !JapaneseDeinflector.passesContextRule(rule, current, term, suffixLen)
+                        ) {
+                            continue
+                        }
+                        if (rule.toTags != 0L && current.conditions != 0L &&
+                            (current.conditions and rule.toTags) == 0L
+                        ) {
+                            continue
+                        }
+
+                        val newTerm = term.dropLast(suffixLen) + rule.toEnding
+                        if (newTerm.isEmpty()) continue
+
+                        val newReasons = if (rule.detail.isNotBlank()) {
+                            ArrayDeque(current.reasons).also { it.addLast(rule.detail) }
+                        } else {
+                            ArrayDeque(current.reasons)
+                        }
+                        val newConditions = rule.fromTags
+
+                        val outputIsAnyStem = (newConditions and ALL_STEMS) != 0L
+                        val outputIsDictionaryForm = !outputIsAnyStem && newConditions != 0L
+                        val outputIsRenyouStem = (newConditions and STEM_REN) != 0L
+                        val canBeFinal = when (rule.type) {
+                            RuleType.NEVER_FINAL -> outputIsDictionaryForm
+                            RuleType.ONLY_FINAL -> outputIsDictionaryForm || outputIsRenyouStem
+                            RuleType.STANDARD, RuleType.CONTEXT, RuleType.REWRITE ->
+                                !outputIsAnyStem || outputIsRenyouStem
+                        }
+
+                        if ("$newTerm:$newConditions" in processed) continue
+
+                        val newCandidate = Candidate(
+                            term = newTerm,
+                            conditions = newConditions,
+                            reasons = newReasons,
+                            canBeFinal = canBeFinal,
+                            hasAppliedRule = true,
+                        )
+                        queue.add(newCandidate)
+
+                        val existing = results[newTerm]
+                        if (existing == null || existing.reasons.size > newReasons.size) {
+                            results[newTerm] = newCandidate
+                        } else if (existing.reasons.size == newReasons.size) {
+                            val combinedConditions = existing.conditions or newConditions
+                            val preferFinal = canBeFinal || existing.canBeFinal
+
+                            if (combinedConditions != existing.conditions || preferFinal != existing.canBeFinal) {
+                                val allChains = LinkedHashSet<List<String>>()
+                                allChains.add(existing.reasons.toList())
+                                allChains.addAll(existing.alternateReasonChains)
+                                allChains.add(newReasons.toList())
+
+                                val primaryChain = allChains.minWithOrNull(
+                                    compareBy({ it.size }, { it.joinToString("\u0000") }),
+                                ) ?: existing.reasons.toList()
+
+                                results[newTerm] = existing.copy(
+                                    conditions = combinedConditions,
+                                    canBeFinal = preferFinal,
+                                    reasons = ArrayDeque(primaryChain),
+                                    alternateReasonChains = allChains.filterNot { it == primaryChain }.toSet(),
+                                )
+                            }
+                        }
+                    }
+                }
+            }
+
+            return results.values.filter { it.canBeFinal }
+        }
+    }
+
+    private companion object {
+        const val TIMING_WARMUP_ROUNDS = 3
+        const val TIMING_ROUNDS = 5
+    }
+}
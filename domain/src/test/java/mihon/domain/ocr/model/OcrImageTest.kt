@@ -0,0 +1,54 @@
+package mihon.domain.ocr.model
+
+import io.kotest.matchers.shouldBe
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.assertThrows
+
+class OcrImageTest {
+
+    @Test
+    fun `backing storage is freed only when the last reference is released`() {
+        val image = TrackingImage()
+
+        image.retain()
+        image.release()
+        image.releaseCount shouldBe 0
+        image.isReleased shouldBe false
+
+        image.close()
+        image.releaseCount shouldBe 1
+        image.isReleased shouldBe true
+    }
+
+    @Test
+    fun `released image cannot be retained or released again`() {
+        val image = TrackingImage()
+        image.release()
+
+        assertThrows<IllegalStateException> { image.retain() }
+        assertThrows<IllegalStateException> { image.release() }
+        image.releaseCount shouldBe 1
+    }
+
+    @Test
+    fun `pixel images validate size and hand out copies`() {
+        val pixels = intArrayOf(1, 2, 3, 4)
+        val image = OcrImage.fromPixels(width = 2, height = 2, pixels = pixels)
+
+        val copy = image.copyPixels()
+        copy[0] = 9
+
+        pixels[0] shouldBe 1
+        assertThrows<IllegalArgumentException> { OcrImage.fromPixels(width = 3, height = 2, pixels = pixels) }
+    }
+
+    private class TrackingImage : OcrImage(width = 1, height = 1) {
+        var releaseCount = 0
+
+        override fun copyPixels(): IntArray = IntArray(1)
+
+        override fun onReleased() {
+            releaseCount++
+        }
+    }
+}